@@ -0,0 +1,45 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_BENCH_ALLOCATION_COUNTER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_BENCH_ALLOCATION_COUNTER_H_INCLUDED
+
+#include <cstdint>
+
+// Linking AllocationCounter.cpp replaces global operator new and delete
+// with ones that count allocations of all threads, on top of malloc and free.
+
+struct AllocationCounters
+{
+    uint64_t count;
+    uint64_t bytes;
+};
+
+/// Totals since the start of the process, take difference of two to measure a piece of code.
+AllocationCounters getAllocationCounters();
+
+/// Counts allocations made during its lifetime.
+class AllocationScope
+{
+public:
+    AllocationScope()
+        : start(getAllocationCounters())
+    {}
+
+    uint64_t getCount() const
+    {
+        return getAllocationCounters().count - start.count;
+    }
+
+    uint64_t getBytes() const
+    {
+        return getAllocationCounters().bytes - start.bytes;
+    }
+
+private:
+    const AllocationCounters start;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_BENCH_ALLOCATION_COUNTER_H_INCLUDED
@@ -0,0 +1,96 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "Benchmark.h"
+
+#include "AllocationCounter.h"
+#include "PerfCounters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+
+const double MinBenchmarkSeconds = 0.2;
+
+std::unique_ptr<PerfCounters> perfCounters;
+
+void printPerfCounters(size_t runs, double items, double bytes, const std::function<void ()>& body)
+{
+    // Separate pass, so that reading the clock is not counted.
+    perfCounters->start();
+    for (size_t i = 0; i < runs; ++i)
+    {
+        body();
+    }
+    const PerfCounterValues counters = perfCounters->stop();
+
+    std::printf("%4s", "");
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        const double value = counters.values[i];
+        std::printf("%s %s", i == 0 ? "" : ",", PerfCounters::getName(static_cast<PerfCounterType>(i)));
+        if (value < 0)
+        {
+            std::printf(" n/a");
+            continue;
+        }
+        std::printf(" %.1f/item", value / items);
+        if (bytes > 0)
+        {
+            std::printf(" %.2f/byte", value / bytes);
+        }
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+void enablePerfCounters()
+{
+    perfCounters.reset(new PerfCounters);
+    if (!perfCounters->getError().empty())
+    {
+        std::printf("Some hardware counters are unavailable (%s)\n", perfCounters->getError().c_str());
+    }
+    if (!perfCounters->isAvailable())
+    {
+        perfCounters.reset();
+    }
+}
+
+void runBenchmark(const std::string& name, size_t itemsPerRun, size_t bytesPerRun,
+        const std::function<void ()>& body)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up caches and allocator.
+    body();
+
+    size_t runs = 0;
+    double seconds = 0;
+    const AllocationScope allocations;
+    const Clock::time_point start = Clock::now();
+    do
+    {
+        body();
+        ++runs;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    while (seconds < MinBenchmarkSeconds);
+
+    const double items = static_cast<double>(itemsPerRun) * runs;
+    const double bytes = static_cast<double>(bytesPerRun) * runs;
+    std::printf("%-48s %12.1f ns/item %10.1f MiB/s %8.2f allocs/item %10.1f B/item\n", name.c_str(),
+            seconds * 1e9 / items, bytes / seconds / (1024 * 1024),
+            allocations.getCount() / items, allocations.getBytes() / items);
+
+    if (perfCounters)
+    {
+        printPerfCounters(runs, items, bytes, body);
+    }
+}
@@ -0,0 +1,30 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_BENCH_BENCHMARK_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_BENCH_BENCHMARK_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/// Runs body repeatedly for at least minimal duration, then prints a line with
+/// time per item, throughput and heap allocations per item, of all threads.
+/// Each run of body processes itemsPerRun items of bytesPerRun bytes total.
+void runBenchmark(const std::string& name, size_t itemsPerRun, size_t bytesPerRun,
+        const std::function<void ()>& body);
+
+/// Makes runBenchmark repeat body as many times with hardware counters on and print them
+/// per item and per byte. Prints a warning and keeps measuring time only if counters are unavailable.
+void enablePerfCounters();
+
+/// Prevents compiler from optimizing away computation of the value.
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif // EQUEUM_FUNCTION_PARSER_BENCH_BENCHMARK_H_INCLUDED
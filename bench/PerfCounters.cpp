@@ -0,0 +1,176 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+#ifdef __linux__
+
+struct PerfEventConfig
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+PerfEventConfig getPerfEventConfig(PerfCounterType type)
+{
+    switch (type)
+    {
+        case PERF_COUNTER_CYCLES:
+            return PerfEventConfig{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case PERF_COUNTER_INSTRUCTIONS:
+            return PerfEventConfig{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case PERF_COUNTER_BRANCH_MISSES:
+            return PerfEventConfig{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+        case PERF_COUNTER_L1D_MISSES:
+            return PerfEventConfig{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        case PERF_COUNTER_COUNT:
+            break;
+    }
+    return PerfEventConfig{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+}
+
+int openPerfEvent(PerfCounterType type)
+{
+    const PerfEventConfig config = getPerfEventConfig(type);
+
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = config.type;
+    attr.config = config.config;
+    attr.disabled = 1;
+    // Counting user space only works with the default perf_event_paranoid.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif // __linux__
+
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+#ifdef __linux__
+        fds[i] = openPerfEvent(static_cast<PerfCounterType>(i));
+        if (fds[i] < 0)
+        {
+            error += std::string(error.empty() ? "" : ", ") + getName(static_cast<PerfCounterType>(i))
+                    + ": " + std::strerror(errno);
+        }
+#else
+        fds[i] = -1;
+        error = "perf_event_open is only available on Linux";
+#endif
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const std::string& PerfCounters::getError() const
+{
+    return error;
+}
+
+void PerfCounters::start()
+{
+#ifdef __linux__
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfCounterValues PerfCounters::stop()
+{
+    PerfCounterValues result;
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        result.values[i] = -1;
+#ifdef __linux__
+        if (fds[i] < 0)
+        {
+            continue;
+        }
+        ::ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time enabled, time running
+        uint64_t data[3] = {0, 0, 0};
+        if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+        // Counter was running only part of the time if more counters are open than the PMU has.
+        result.values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+#endif
+    }
+
+    return result;
+}
+
+const char* PerfCounters::getName(PerfCounterType type)
+{
+    switch (type)
+    {
+        case PERF_COUNTER_CYCLES:
+            return "cycles";
+        case PERF_COUNTER_INSTRUCTIONS:
+            return "instructions";
+        case PERF_COUNTER_BRANCH_MISSES:
+            return "branch-misses";
+        case PERF_COUNTER_L1D_MISSES:
+            return "L1d-misses";
+        case PERF_COUNTER_COUNT:
+            break;
+    }
+    return "unknown";
+}
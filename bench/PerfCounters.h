@@ -0,0 +1,57 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_BENCH_PERF_COUNTERS_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_BENCH_PERF_COUNTERS_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+enum PerfCounterType : int
+{
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_L1D_MISSES, // L1 data cache read misses
+
+    PERF_COUNTER_COUNT
+};
+
+struct PerfCounterValues
+{
+    // Negative if the counter is unavailable.
+    double values[PERF_COUNTER_COUNT];
+};
+
+/// Hardware counters of the calling thread, user space only, via perf_event_open(2).
+/// Counters that can't be opened (no PMU in a VM, perf_event_paranoid, seccomp, not Linux)
+/// are reported as unavailable, others still work.
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// True if at least one counter is available.
+    bool isAvailable() const;
+    /// Why counters are unavailable, empty if all are available.
+    const std::string& getError() const;
+
+    /// Resets and starts counting.
+    void start();
+    /// Stops counting and returns counts since start(), scaled if counters were multiplexed.
+    PerfCounterValues stop();
+
+    static const char* getName(PerfCounterType type);
+
+private:
+    int fds[PERF_COUNTER_COUNT];
+    std::string error;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_BENCH_PERF_COUNTERS_H_INCLUDED
@@ -0,0 +1,333 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "Benchmark.h"
+
+#include "CallBinder.h"
+#include "FunctionCallBatchParser.h"
+#include "ExpressionProgram.h"
+#include "FunctionCallEncoding.h"
+#include "FunctionDispatcher.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+#include "FunctionWriter.h"
+#include "Lexer.h"
+#include "ParsedCallCache.h"
+#include "ParserContext.h"
+#include "PreparedFunctionCall.h"
+#include "ThreadPool.h"
+#include "Tokenizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// Inputs of wildly varying length: from "f()" to multi-KB string literals.
+std::vector<std::string> makeMixedInputs(size_t count)
+{
+    std::mt19937 random(42);
+    std::vector<std::string> inputs;
+    inputs.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        switch (random() % 4)
+        {
+            case 0:
+                inputs.push_back("f()");
+                break;
+            case 1:
+                inputs.push_back("function(1, 2.5, c=3, d=\"foobar\")");
+                break;
+            case 2:
+                inputs.push_back("g(a=\"" + std::string(random() % 8192, 'x') + "\")");
+                break;
+            default:
+                inputs.push_back("h(" + std::to_string(random()) + ", \"\\\"escaped\\\"\")");
+                break;
+        }
+    }
+
+    return inputs;
+}
+
+size_t getTotalSize(const std::vector<std::string>& inputs)
+{
+    size_t result = 0;
+    for (const auto& input : inputs)
+    {
+        result += input.size();
+    }
+
+    return result;
+}
+
+void benchmarkTokenizer(const std::vector<std::string>& inputs)
+{
+    runBenchmark("Tokenizer::getNextToken", inputs.size(), getTotalSize(inputs), [&inputs]()
+    {
+        for (const auto& input : inputs)
+        {
+            Tokenizer tokenizer(input);
+            while (tokenizer.getNextToken().type != TOKEN_END_OF_INPUT)
+            {}
+            doNotOptimize(tokenizer);
+        }
+    });
+}
+
+void benchmarkLexer(const std::vector<std::string>& inputs)
+{
+    runBenchmark("Lexer::getNextLexeme", inputs.size(), getTotalSize(inputs), [&inputs]()
+    {
+        for (const auto& input : inputs)
+        {
+            Lexer lexer(input);
+            Lexeme lexeme;
+            do
+            {
+                lexeme = lexer.getNextLexeme();
+            }
+            while (lexeme.type != LEX_END_OF_INPUT && lexeme.type != LEX_ERROR);
+            doNotOptimize(lexeme);
+        }
+    });
+}
+
+void benchmarkParseFunctionCall(const std::vector<std::string>& inputs)
+{
+    runBenchmark("parseFunctionCall", inputs.size(), getTotalSize(inputs), [&inputs]()
+    {
+        for (const auto& input : inputs)
+        {
+            doNotOptimize(tryParseFunctionCall(input));
+        }
+    });
+
+    ParserContext context;
+    FunctionCall call;
+    runBenchmark("ParserContext::parseCall", inputs.size(), getTotalSize(inputs), [&inputs, &context, &call]()
+    {
+        for (const auto& input : inputs)
+        {
+            context.reset(input);
+            doNotOptimize(context.parseCall(call));
+        }
+    });
+}
+
+void benchmarkUpdateFunctionCall()
+{
+    FunctionRegistry registry;
+    registry.addFunction("function(a, b, c=3, d=\"foobar\", e=5.0, f=6)");
+    const FunctionCall call = parseFunctionCall("function(1, 2.5, e=3)", &registry.getSymbolTable());
+
+    runBenchmark("updateFunctionCall", 1, 0, [&registry, &call]()
+    {
+        doNotOptimize(registry.updateFunctionCall(call));
+    });
+
+    // Same call, from text and from the prepared template.
+    const std::string input = "function(1, 2.5, e=3)";
+    runBenchmark("parseFunctionCall+updateFunctionCall", 1, input.size(), [&registry, &input]()
+    {
+        doNotOptimize(registry.updateFunctionCall(parseFunctionCall(input, &registry.getSymbolTable())));
+    });
+
+    const PreparedFunctionCall prepared = prepareFunctionCall("function(?, ?, e=?)", registry).getValue();
+    const std::string values[] = {"1", "2.5", "3"};
+    FunctionCall bound;
+    runBenchmark("PreparedFunctionCall::bind", 1, 0, [&prepared, &values, &bound]()
+    {
+        prepared.bind(values, 3, bound);
+        doNotOptimize(bound);
+    });
+}
+
+void benchmarkCallBinder()
+{
+    const auto binder = makeCallBinder<void (int64_t, double, int64_t, boost::string_view)>(
+            parseFunctionSpec("function(a, b, c=3, d=\"foobar\")"));
+    const std::string input = "function(1, 2.5, c=3, d=\"foobar\")";
+
+    runBenchmark("CallBinder::bind", 1, input.size(), [&binder, &input]()
+    {
+        doNotOptimize(binder.bind(input));
+    });
+}
+
+void benchmarkFunctionDispatcher()
+{
+    FunctionDispatcher<int64_t> dispatcher;
+    for (int i = 0; i < 100; ++i)
+    {
+        dispatcher.addFunction<int64_t (int64_t, int64_t)>("function" + std::to_string(i) + "(a, b=2)",
+                [](int64_t a, int64_t b) { return a + b; });
+    }
+    const std::string input = "function99(1, b=2)";
+
+    runBenchmark("FunctionDispatcher::dispatch", 1, input.size(), [&dispatcher, &input]()
+    {
+        doNotOptimize(dispatcher.dispatch(input));
+    });
+}
+
+void benchmarkExpressionProgram()
+{
+    ExpressionFunctionTable functions;
+    functions.addFunction("clamp(x, low=0, high=100)", [](const ExpressionValue* arguments, size_t)
+    {
+        return std::min(std::max(arguments[0].number, arguments[1].number), arguments[2].number);
+    });
+    double price = 0;
+    functions.addFunction("price()", [&price](const ExpressionValue*, size_t)
+    {
+        return price += 0.5;
+    });
+    const std::string input = "clamp(price() * 1.2 - 3, high=price() + 10) / 2";
+
+    runBenchmark("compileExpression", 1, input.size(), [&functions, &input]()
+    {
+        doNotOptimize(compileExpression(input, functions));
+    });
+
+    const ExpressionProgram program = compileExpression(input, functions).getValue();
+    runBenchmark("ExpressionProgram::evaluate", 1, 0, [&program]()
+    {
+        doNotOptimize(program.evaluate());
+    });
+
+    // Same expression with inputs instead of price() calls.
+    const ExpressionProgram programWithInputs =
+            compileExpression("clamp(? * 1.2 - 3, high=? + 10) / 2", functions).getValue();
+    ExpressionValue inputs[2] = {{EXPRESSION_VALUE_NUMBER, 0, {}}, {EXPRESSION_VALUE_NUMBER, 0, {}}};
+    runBenchmark("ExpressionProgram::evaluate(inputs)", 1, 0, [&programWithInputs, &inputs]()
+    {
+        inputs[0].number += 0.5;
+        inputs[1].number += 0.5;
+        doNotOptimize(programWithInputs.evaluate(inputs, 2));
+    });
+}
+
+void benchmarkFunctionCallEncoding(const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> encoded;
+    size_t encodedSize = 0;
+    for (const auto& input : inputs)
+    {
+        encoded.push_back(encodeFunctionCall(parseFunctionCall(input)));
+        encodedSize += encoded.back().size();
+    }
+
+    runBenchmark("EncodedFunctionCallView::read", encoded.size(), encodedSize, [&encoded]()
+    {
+        for (const auto& data : encoded)
+        {
+            doNotOptimize(EncodedFunctionCallView::read(data));
+        }
+    });
+
+    runBenchmark("decodeFunctionCall", encoded.size(), encodedSize, [&encoded]()
+    {
+        for (const auto& data : encoded)
+        {
+            doNotOptimize(decodeFunctionCall(EncodedFunctionCallView::read(data).getValue()));
+        }
+    });
+}
+
+void benchmarkFunctionWriter(const std::vector<std::string>& inputs)
+{
+    std::vector<FunctionCall> calls;
+    for (const auto& input : inputs)
+    {
+        calls.push_back(parseFunctionCall(input));
+    }
+
+    std::string output;
+    runBenchmark("writeFunctionCall", calls.size(), getTotalSize(inputs), [&calls, &output]()
+    {
+        output.clear();
+        for (const auto& call : calls)
+        {
+            writeFunctionCall(call, output);
+        }
+        doNotOptimize(output);
+    });
+
+    const std::string value = std::string(4096, 'x') + "\"" + std::string(4096, 'y');
+    runBenchmark("writeStringLiteral", 1, value.size(), [&value, &output]()
+    {
+        output.clear();
+        writeStringLiteral(value, output);
+        doNotOptimize(output);
+    });
+}
+
+void benchmarkParsedCallCache(const std::vector<std::string>& inputs)
+{
+    ParsedCallCache cache(256 * 1024 * 1024);
+    runBenchmark("ParsedCallCache/hits", inputs.size(), getTotalSize(inputs), [&inputs, &cache]()
+    {
+        for (const auto& input : inputs)
+        {
+            doNotOptimize(cache.parse(input));
+        }
+    });
+}
+
+void benchmarkParseFunctionCallsScaling(const std::vector<std::string>& inputs)
+{
+    const std::vector<boost::string_view> views(inputs.begin(), inputs.end());
+    for (size_t threads = 1; threads <= 64; threads *= 2)
+    {
+        ThreadPool pool(threads);
+        runBenchmark("parseFunctionCalls/threads:" + std::to_string(threads),
+                inputs.size(), getTotalSize(inputs), [&views, &pool]()
+        {
+            doNotOptimize(parseFunctionCalls(views, pool));
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--perf-counters") == 0)
+        {
+            enablePerfCounters();
+        }
+        else
+        {
+            std::printf("Usage: %s [--perf-counters]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const std::vector<std::string> inputs = makeMixedInputs(10000);
+
+    benchmarkTokenizer(inputs);
+    benchmarkLexer(inputs);
+    benchmarkParseFunctionCall(inputs);
+    benchmarkUpdateFunctionCall();
+    benchmarkCallBinder();
+    benchmarkFunctionDispatcher();
+    benchmarkExpressionProgram();
+    benchmarkFunctionCallEncoding(inputs);
+    benchmarkFunctionWriter(inputs);
+    benchmarkParsedCallCache(inputs);
+    benchmarkParseFunctionCallsScaling(inputs);
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_ARGUMENT_CONVERTER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_ARGUMENT_CONVERTER_H_INCLUDED
+
+#include "Lexer.h"
+#include "StringView.h"
+
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+/// Correctly rounded value of a number literal, with '.' as decimal point whatever the
+/// C and C++ global locales are, unlike std::strtod. Allocates, so only for the rare cases.
+inline double parseRealLiteral(boost::string_view literal)
+{
+    std::istringstream stream(literal.to_string());
+    stream.imbue(std::locale::classic());
+
+    double result = 0;
+    if (!(stream >> result))
+    {
+        // Out of range, stream gives max() rather than infinity as std::strtod does.
+        return result < 0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    }
+    return result;
+}
+
+/// Converts number or string literal Lexeme to native type T, returns false if not possible.
+/// Supported types are integers, floating point numbers, std::string and boost::string_view.
+template <typename T, typename Enable = void>
+struct ArgumentConverter;
+
+template <typename T>
+struct ArgumentConverter<T, typename std::enable_if<std::is_integral<T>::value
+        && !std::is_same<T, bool>::value>::type>
+{
+    /// Only integers without decimal point, overflow is an error.
+    /// Leading '-' comes from folded constants and is allowed only for signed types.
+    static bool convert(const Lexeme& lex, T& result)
+    {
+        if (lex.type != LEX_NUMBER_LITERAL)
+        {
+            return false;
+        }
+
+        boost::string_view digits = lex.value;
+        const bool isNegative = !digits.empty() && digits[0] == '-';
+        if (isNegative)
+        {
+            if (!std::is_signed<T>::value)
+            {
+                return false;
+            }
+            digits.remove_prefix(1);
+        }
+        if (digits.empty())
+        {
+            return false;
+        }
+
+        // Magnitude of the min value is one more than of max value.
+        const uint64_t maxValue = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (isNegative ? 1 : 0);
+        uint64_t value = 0;
+        for (const char c : digits)
+        {
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+
+            const uint64_t digit = static_cast<uint64_t>(c - '0');
+            if (value > (maxValue - digit) / 10)
+            {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+
+        if (isNegative && value != 0)
+        {
+            // -(value - 1) - 1 doesn't overflow even for the min value.
+            result = static_cast<T>(-static_cast<T>(value - 1) - 1);
+        }
+        else
+        {
+            result = static_cast<T>(value);
+        }
+        return true;
+    }
+};
+
+template <typename T>
+struct ArgumentConverter<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static bool convert(const Lexeme& lex, T& result)
+    {
+        if (lex.type != LEX_NUMBER_LITERAL)
+        {
+            return false;
+        }
+
+        // Exact powers of ten representable in double.
+        static const double PowersOfTen[] =
+        {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        const uint64_t MaxExactMantissa = uint64_t(1) << 53;
+
+        boost::string_view digits = lex.value;
+        const bool isNegative = !digits.empty() && digits[0] == '-';
+        if (isNegative)
+        {
+            digits.remove_prefix(1);
+        }
+
+        // Fast path: mantissa and power of ten are both exact in double, so is the quotient.
+        uint64_t mantissa = 0;
+        size_t fractionDigits = 0;
+        bool isFraction = false;
+        for (const char c : digits)
+        {
+            if (c == '.')
+            {
+                isFraction = true;
+                continue;
+            }
+
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            fractionDigits += isFraction;
+            if (mantissa >= MaxExactMantissa)
+            {
+                // Slow path, rare enough to afford the allocation.
+                result = static_cast<T>(parseRealLiteral(lex.value));
+                return true;
+            }
+        }
+
+        if (fractionDigits >= sizeof(PowersOfTen) / sizeof(PowersOfTen[0]))
+        {
+            result = static_cast<T>(parseRealLiteral(lex.value));
+            return true;
+        }
+
+        const double value = static_cast<double>(mantissa) / PowersOfTen[fractionDigits];
+        result = static_cast<T>(isNegative ? -value : value);
+        return true;
+    }
+};
+
+/// Removes quotes and backslashes that escape characters.
+inline std::string unescapeStringLiteral(boost::string_view literal)
+{
+    literal.remove_prefix(1);
+    literal.remove_suffix(1);
+
+    std::string result;
+    result.reserve(literal.size());
+    for (size_t i = 0; i < literal.size(); ++i)
+    {
+        if (literal[i] == '\\' && i + 1 < literal.size())
+        {
+            ++i;
+        }
+        result.push_back(literal[i]);
+    }
+
+    return result;
+}
+
+template <>
+struct ArgumentConverter<std::string>
+{
+    static bool convert(const Lexeme& lex, std::string& result)
+    {
+        if (lex.type != LEX_STRING_LITERAL)
+        {
+            return false;
+        }
+
+        result = unescapeStringLiteral(lex.value);
+        return true;
+    }
+};
+
+template <>
+struct ArgumentConverter<boost::string_view>
+{
+    /// Points into the input, hence string literals with escapes can't be converted.
+    static bool convert(const Lexeme& lex, boost::string_view& result)
+    {
+        if (lex.type != LEX_STRING_LITERAL || lex.value.find('\\') != boost::string_view::npos)
+        {
+            return false;
+        }
+
+        result = lex.value.substr(1, lex.value.size() - 2);
+        return true;
+    }
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_ARGUMENT_CONVERTER_H_INCLUDED
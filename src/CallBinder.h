@@ -0,0 +1,254 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_CALL_BINDER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_CALL_BINDER_H_INCLUDED
+
+#include "ArgumentConverter.h"
+#include "FunctionCallVisitor.h"
+#include "FunctionParser.h"
+#include "Lexer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// Parses calls of a single function straight into a tuple of native types,
+/// in spec parameter order, without building a FunctionCall.
+/// Missing parameters are filled from spec defaults converted once, at construction.
+///
+///     const auto binder = makeCallBinder<void (int64_t, double, boost::string_view)>(spec);
+///     ParseResult<decltype(binder)::Arguments> arguments = binder.bind("f(1, c=\"foo\")");
+///
+/// See ArgumentConverter for supported types, boost::string_view arguments point into the input.
+template <typename Signature>
+class CallBinder;
+
+template <typename R, typename... Args>
+class CallBinder<R (Args...)>
+{
+public:
+    typedef std::tuple<typename std::decay<Args>::type...> Arguments;
+    static const size_t ParameterCount = sizeof...(Args);
+    static_assert(ParameterCount <= 64, "Up to 64 parameters are supported.");
+
+    /// Throws std::invalid_argument if spec has different number of parameters
+    /// or its default values can't be converted to parameter types.
+    explicit CallBinder(const FunctionSpec& functionSpec)
+        : spec(std::make_shared<const FunctionSpec>(functionSpec)),
+          defaults(),
+          defaultsMask(0)
+    {
+        if (spec->parameters.size() != ParameterCount)
+        {
+            throw std::invalid_argument("Number of parameters of \"" + spec->name
+                    + "\" doesn't match the signature.");
+        }
+
+        for (size_t i = 0; i < ParameterCount; ++i)
+        {
+            const FunctionSpecParameter& param = spec->parameters[i];
+            if (!param.value)
+            {
+                continue;
+            }
+
+            // Spec is shared between copies, so views of defaults stay valid.
+            Lexer lexer(*param.value);
+            if (!getConverters()[i](lexer.getNextLexeme(), defaults))
+            {
+                throw std::invalid_argument("Default value of \"" + param.name
+                        + "\" can't be converted to parameter type.");
+            }
+            defaultsMask |= uint64_t(1) << i;
+        }
+    }
+
+    /// On error, arguments are partially assigned.
+    ParseError bind(boost::string_view input, Arguments& arguments) const
+    {
+        Visitor visitor(*this, arguments);
+        const ParseError error = visitFunctionCall(input, visitor);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+
+        const uint64_t allParameters = (ParameterCount == 64)
+                ? ~uint64_t(0)
+                : (uint64_t(1) << ParameterCount) - 1;
+        const uint64_t missing = allParameters & ~visitor.getAssigned();
+        if (missing & ~defaultsMask)
+        {
+            return ParseError{PARSE_ERROR_MISSING_PARAMETER, input.size()};
+        }
+
+        for (size_t i = 0; i < ParameterCount; ++i)
+        {
+            if (missing & (uint64_t(1) << i))
+            {
+                getDefaultCopiers()[i](defaults, arguments);
+            }
+        }
+
+        return ParseError{PARSE_ERROR_NONE, 0};
+    }
+
+    ParseResult<Arguments> bind(boost::string_view input) const
+    {
+        Arguments arguments;
+        const ParseError error = bind(input, arguments);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+
+        return arguments;
+    }
+
+    const FunctionSpec& getFunctionSpec() const
+    {
+        return *spec;
+    }
+
+private:
+    typedef bool (*ConvertFunction)(const Lexeme& lex, Arguments& arguments);
+    typedef void (*CopyFunction)(const Arguments& from, Arguments& to);
+
+    template <size_t I>
+    static bool convertArgument(const Lexeme& lex, Arguments& arguments)
+    {
+        typedef typename std::tuple_element<I, Arguments>::type Type;
+        return ArgumentConverter<Type>::convert(lex, std::get<I>(arguments));
+    }
+
+    template <size_t I>
+    static void copyArgument(const Arguments& from, Arguments& to)
+    {
+        std::get<I>(to) = std::get<I>(from);
+    }
+
+    /// Tables for converting tuple element selected at run time, extra nullptr allows empty Args.
+    template <size_t... I>
+    static const ConvertFunction* getConverters(std::index_sequence<I...>)
+    {
+        static const ConvertFunction converters[] = {&convertArgument<I>..., nullptr};
+        return converters;
+    }
+
+    static const ConvertFunction* getConverters()
+    {
+        return getConverters(std::index_sequence_for<Args...>());
+    }
+
+    template <size_t... I>
+    static const CopyFunction* getDefaultCopiers(std::index_sequence<I...>)
+    {
+        static const CopyFunction copiers[] = {&copyArgument<I>..., nullptr};
+        return copiers;
+    }
+
+    static const CopyFunction* getDefaultCopiers()
+    {
+        return getDefaultCopiers(std::index_sequence_for<Args...>());
+    }
+
+    /// Returns ParameterCount if there is no such parameter.
+    size_t findParameter(boost::string_view name) const
+    {
+        size_t i = 0;
+        for (; i < ParameterCount; ++i)
+        {
+            if (name == spec->parameters[i].name)
+            {
+                break;
+            }
+        }
+
+        return i;
+    }
+
+    class Visitor : public FunctionCallVisitor
+    {
+    public:
+        Visitor(const CallBinder& binder, Arguments& arguments)
+            : binder(binder),
+              arguments(arguments),
+              assigned(0),
+              positionalCount(0)
+        {}
+
+        ParseErrorCode visitFunctionName(const Lexeme& name) override
+        {
+            return (name.value == binder.spec->name) ? PARSE_ERROR_NONE : PARSE_ERROR_UNKNOWN_FUNCTION;
+        }
+
+        ParseErrorCode visitParameter(const Lexeme* name, const Lexeme& value) override
+        {
+            size_t index = positionalCount;
+            if (name)
+            {
+                index = binder.findParameter(name->value);
+                if (index == ParameterCount)
+                {
+                    return PARSE_ERROR_UNKNOWN_PARAMETER;
+                }
+            }
+            else
+            {
+                if (index == ParameterCount)
+                {
+                    return PARSE_ERROR_TOO_MANY_PARAMETERS;
+                }
+                ++positionalCount;
+            }
+
+            const uint64_t bit = uint64_t(1) << index;
+            if (assigned & bit)
+            {
+                return PARSE_ERROR_DUPLICATE_PARAMETER;
+            }
+            assigned |= bit;
+
+            if (!getConverters()[index](value, arguments))
+            {
+                return PARSE_ERROR_INVALID_ARGUMENT_TYPE;
+            }
+
+            return PARSE_ERROR_NONE;
+        }
+
+        uint64_t getAssigned() const
+        {
+            return assigned;
+        }
+
+    private:
+        const CallBinder& binder;
+        Arguments& arguments;
+        uint64_t assigned;
+        size_t positionalCount;
+    };
+
+private:
+    std::shared_ptr<const FunctionSpec> spec;
+    Arguments defaults;
+    uint64_t defaultsMask;
+};
+
+template <typename R, typename... Args>
+const size_t CallBinder<R (Args...)>::ParameterCount;
+
+template <typename Signature>
+CallBinder<Signature> makeCallBinder(const FunctionSpec& spec)
+{
+    return CallBinder<Signature>(spec);
+}
+
+#endif // EQUEUM_FUNCTION_PARSER_CALL_BINDER_H_INCLUDED
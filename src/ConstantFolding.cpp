@@ -0,0 +1,297 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ConstantFolding.h"
+
+#include "ArgumentConverter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+
+const int64_t MinInteger = std::numeric_limits<int64_t>::min();
+const int64_t MaxInteger = std::numeric_limits<int64_t>::max();
+
+Constant makeInteger(int64_t value)
+{
+    return Constant{true, value, 0.0};
+}
+
+Constant makeReal(double value)
+{
+    return Constant{false, 0, value};
+}
+
+/// Returns false if value doesn't convert to double exactly, like 2^53 + 1.
+bool integerToReal(int64_t value, double& result)
+{
+    result = static_cast<double>(value);
+    // 2^63 doesn't fit int64_t, so only rounding up to it can give it.
+    return result < 9223372036854775808.0 && static_cast<int64_t>(result) == value;
+}
+
+bool toReal(const Constant& value, double& result)
+{
+    if (!value.isInteger)
+    {
+        result = value.real;
+        return true;
+    }
+
+    return integerToReal(value.integer, result);
+}
+
+bool checkReal(double value, Constant& result)
+{
+    if (!std::isfinite(value))
+    {
+        return false;
+    }
+
+    result = makeReal(value);
+    return true;
+}
+
+bool addIntegers(int64_t left, int64_t right, int64_t& result)
+{
+    if ((right > 0 && left > MaxInteger - right) || (right < 0 && left < MinInteger - right))
+    {
+        return false;
+    }
+
+    result = left + right;
+    return true;
+}
+
+bool subtractIntegers(int64_t left, int64_t right, int64_t& result)
+{
+    if ((right < 0 && left > MaxInteger + right) || (right > 0 && left < MinInteger + right))
+    {
+        return false;
+    }
+
+    result = left - right;
+    return true;
+}
+
+bool multiplyIntegers(int64_t left, int64_t right, int64_t& result)
+{
+    if (left != 0 && right != 0)
+    {
+        if ((left == -1 && right == MinInteger) || (right == -1 && left == MinInteger))
+        {
+            return false;
+        }
+
+        const int64_t product = static_cast<int64_t>(static_cast<uint64_t>(left) * static_cast<uint64_t>(right));
+        if (product / right != left)
+        {
+            return false;
+        }
+    }
+
+    result = static_cast<int64_t>(static_cast<uint64_t>(left) * static_cast<uint64_t>(right));
+    return true;
+}
+
+bool foldIntegers(ExpressionNodeType operation, int64_t left, int64_t right, Constant& result)
+{
+    int64_t value = 0;
+    switch (operation)
+    {
+        case EXPRESSION_ADD:
+            if (!addIntegers(left, right, value))
+            {
+                return false;
+            }
+            break;
+        case EXPRESSION_SUBTRACT:
+            if (!subtractIntegers(left, right, value))
+            {
+                return false;
+            }
+            break;
+        case EXPRESSION_MULTIPLY:
+            if (!multiplyIntegers(left, right, value))
+            {
+                return false;
+            }
+            break;
+        case EXPRESSION_DIVIDE:
+            if (right == 0 || (left == MinInteger && right == -1))
+            {
+                return false;
+            }
+            if (left % right != 0)
+            {
+                double realLeft = 0;
+                double realRight = 0;
+                return integerToReal(left, realLeft) && integerToReal(right, realRight)
+                        && checkReal(realLeft / realRight, result);
+            }
+            value = left / right;
+            break;
+        default:
+            return false;
+    }
+
+    result = makeInteger(value);
+    return true;
+}
+
+bool foldReals(ExpressionNodeType operation, double left, double right, Constant& result)
+{
+    switch (operation)
+    {
+        case EXPRESSION_ADD:
+            return checkReal(left + right, result);
+        case EXPRESSION_SUBTRACT:
+            return checkReal(left - right, result);
+        case EXPRESSION_MULTIPLY:
+            return checkReal(left * right, result);
+        case EXPRESSION_DIVIDE:
+            return std::fpclassify(right) != FP_ZERO && checkReal(left / right, result);
+        default:
+            return false;
+    }
+}
+
+/// Shortest decimal digits and exponent that round-trip, like "15" and 2 for 1.5e2.
+void getShortestDigits(double value, std::string& digits, int& exponent)
+{
+    // sign, 17 digits, point, 'e', exponent sign, 3 digits of exponent and '\0'
+    char buffer[32];
+    for (int precision = 1; precision <= std::numeric_limits<double>::max_digits10; ++precision)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+        // Bitwise comparison, value is finite and non-negative.
+        const double parsed = std::strtod(buffer, nullptr);
+        if (std::memcmp(&parsed, &value, sizeof(value)) == 0)
+        {
+            break;
+        }
+    }
+
+    digits.clear();
+    const char* p = buffer;
+    for (; *p != 'e'; ++p)
+    {
+        if (*p >= '0' && *p <= '9')
+        {
+            digits.push_back(*p);
+        }
+    }
+    exponent = std::atoi(p + 1);
+
+    while (digits.size() > 1 && digits.back() == '0')
+    {
+        digits.pop_back();
+    }
+}
+
+void writeReal(double value, std::string& output)
+{
+    std::string digits;
+    int exponent = 0;
+    getShortestDigits(std::fabs(value), digits, exponent);
+
+    if (std::signbit(value))
+    {
+        output.push_back('-');
+    }
+
+    // Number of digits before decimal point.
+    const int pointPosition = exponent + 1;
+    const int digitCount = static_cast<int>(digits.size());
+    if (pointPosition <= 0)
+    {
+        output += "0.";
+        output.append(static_cast<size_t>(-pointPosition), '0');
+        output += digits;
+    }
+    else if (pointPosition >= digitCount)
+    {
+        output += digits;
+        output.append(static_cast<size_t>(pointPosition - digitCount), '0');
+        output += ".0";
+    }
+    else
+    {
+        output.append(digits, 0, static_cast<size_t>(pointPosition));
+        output.push_back('.');
+        output.append(digits, static_cast<size_t>(pointPosition), std::string::npos);
+    }
+}
+
+} // namespace
+
+bool parseConstant(boost::string_view literal, Constant& result)
+{
+    const Lexeme lex{literal, LEX_NUMBER_LITERAL, 0};
+    if (literal.find('.') == boost::string_view::npos)
+    {
+        int64_t value = 0;
+        if (!ArgumentConverter<int64_t>::convert(lex, value))
+        {
+            return false;
+        }
+
+        result = makeInteger(value);
+        return true;
+    }
+
+    double value = 0;
+    return ArgumentConverter<double>::convert(lex, value) && checkReal(value, result);
+}
+
+bool foldConstant(ExpressionNodeType operation, const Constant& operand, Constant& result)
+{
+    if (operation != EXPRESSION_NEGATE)
+    {
+        return false;
+    }
+
+    if (!operand.isInteger)
+    {
+        return checkReal(-operand.real, result);
+    }
+
+    if (operand.integer == MinInteger)
+    {
+        return false;
+    }
+
+    result = makeInteger(-operand.integer);
+    return true;
+}
+
+bool foldConstant(ExpressionNodeType operation, const Constant& left, const Constant& right, Constant& result)
+{
+    if (left.isInteger && right.isInteger)
+    {
+        return foldIntegers(operation, left.integer, right.integer, result);
+    }
+
+    double realLeft = 0;
+    double realRight = 0;
+    return toReal(left, realLeft) && toReal(right, realRight) && foldReals(operation, realLeft, realRight, result);
+}
+
+void writeConstant(const Constant& value, std::string& output)
+{
+    if (value.isInteger)
+    {
+        output += std::to_string(value.integer);
+    }
+    else
+    {
+        writeReal(value.real, output);
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_CONSTANT_FOLDING_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_CONSTANT_FOLDING_H_INCLUDED
+
+#include "Expression.h"
+#include "StringView.h"
+
+#include <cstdint>
+#include <string>
+
+/// Value of the constant arithmetic expression, integer unless some operand is fractional
+/// or integer division has a remainder.
+struct Constant
+{
+    bool isInteger;
+    int64_t integer; // valid only if isInteger
+    double real; // valid only if !isInteger
+};
+
+/// Returns false if number literal doesn't fit int64_t or double.
+bool parseConstant(boost::string_view literal, Constant& result);
+
+/// Returns false if result can't be computed exactly: integer overflow, division by zero,
+/// infinity or NaN, or integer operand of real arithmetic that doesn't convert to double
+/// exactly. Those expressions are left unfolded. Real arithmetic itself is IEEE double,
+/// so 0.1 + 0.2 folds to 0.30000000000000004.
+bool foldConstant(ExpressionNodeType operation, const Constant& operand, Constant& result);
+bool foldConstant(ExpressionNodeType operation, const Constant& left, const Constant& right, Constant& result);
+
+/// Appends number literal that parses back to the same constant, possibly with leading '-'.
+/// Non-integer values always have a decimal point, e.g. "3.0", and never an exponent.
+void writeConstant(const Constant& value, std::string& output);
+
+#endif // EQUEUM_FUNCTION_PARSER_CONSTANT_FOLDING_H_INCLUDED
@@ -0,0 +1,98 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_EXPRESSION_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_EXPRESSION_H_INCLUDED
+
+#include "ParseError.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum ExpressionNodeType : int
+{
+    EXPRESSION_NUMBER, // number literal
+    EXPRESSION_STRING, // string literal, with quotes and escapes
+    EXPRESSION_CALL, // function call, children are arguments
+    EXPRESSION_NEGATE, // unary minus, single child
+    EXPRESSION_ADD, // binary operators, two children
+    EXPRESSION_SUBTRACT,
+    EXPRESSION_MULTIPLY,
+    EXPRESSION_DIVIDE,
+    EXPRESSION_INPUT, // '?' placeholder of a value given on evaluation, see ExpressionProgram.h
+};
+
+typedef uint32_t ExpressionNodeIndex;
+
+const ExpressionNodeIndex InvalidExpressionNodeIndex = 0xFFFFFFFF;
+
+struct ExpressionNode
+{
+    ExpressionNodeType type;
+    boost::string_view value; // literal, function name or operator.
+    boost::string_view name; // parameter name if node is a named argument of a call, empty otherwise.
+    ExpressionNodeIndex firstChild;
+    ExpressionNodeIndex nextSibling;
+    uint32_t childCount;
+    size_t offset; // byte offset of the value in the input.
+};
+
+/// Expression AST stored in a single contiguous array, nodes refer to each other by index.
+/// Children are added before the parent, so root is the last node of a parsed expression.
+/// Views in nodes point into the parsed input or into the tree itself, for folded constants,
+/// hence the tree can be moved but not copied.
+class ExpressionTree
+{
+public:
+    ExpressionTree();
+    ExpressionTree(ExpressionTree&& other);
+    ExpressionTree& operator=(ExpressionTree&& other);
+    ~ExpressionTree();
+
+    /// Returns index of the added node.
+    ExpressionNodeIndex addNode(const ExpressionNode& node);
+    /// Removes nodes with indices starting from size, e.g. a subtree that was added last.
+    void truncate(size_t size);
+    /// Stores text owned by the tree, view stays valid until clear().
+    boost::string_view addText(std::string text);
+
+    const ExpressionNode& getNode(ExpressionNodeIndex index) const
+    {
+        return nodes[index];
+    }
+
+    ExpressionNode& getNode(ExpressionNodeIndex index)
+    {
+        return nodes[index];
+    }
+
+    ExpressionNodeIndex getRoot() const;
+    void setRoot(ExpressionNodeIndex index);
+
+    size_t getSize() const;
+    /// Keeps allocated memory for reuse.
+    void clear();
+
+private:
+    std::vector<ExpressionNode> nodes;
+    // Deque never relocates elements, even when moved, so views of the texts stay valid.
+    // Created by the first addText(), since empty deque allocates and most trees have no texts.
+    std::unique_ptr<std::deque<std::string>> texts;
+    ExpressionNodeIndex root;
+};
+
+/// Parses single expression: number and string literals, function calls
+/// with positional and named arguments, + - * / with usual precedence, unary minus
+/// and parentheses, e.g. `f(g(1), x=-(2 + 3) * 4)`.
+/// Arithmetic on number literals only is folded into a single number, see ConstantFolding.h.
+/// If allowInputs is set, '?' is allowed wherever a literal is and is parsed as EXPRESSION_INPUT.
+ParseResult<ExpressionTree> tryParseExpression(boost::string_view input, bool allowInputs = false);
+
+#endif // EQUEUM_FUNCTION_PARSER_EXPRESSION_H_INCLUDED
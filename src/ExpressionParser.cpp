@@ -0,0 +1,483 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ExpressionParser.h"
+
+#include "ConstantFolding.h"
+
+#include <string>
+#include <utility>
+
+namespace
+{
+
+const ParseError NoError{PARSE_ERROR_NONE, 0};
+
+bool isOperator(const Lexeme& lex, char op)
+{
+    return lex.type == LEX_OPERATOR && lex.value.size() == 1 && lex.value[0] == op;
+}
+
+bool isComma(const Lexeme& lex)
+{
+    return lex.type == LEX_PUNCTUATION && lex.value == ",";
+}
+
+bool isQuestionMark(const Lexeme& lex)
+{
+    return lex.type == LEX_PUNCTUATION && lex.value == "?";
+}
+
+bool canStartExpression(const Lexeme& lex)
+{
+    return lex.type == LEX_NUMBER_LITERAL || lex.type == LEX_STRING_LITERAL || lex.type == LEX_NAME
+            || lex.type == LEX_LEFT_PARENTHESIS || isOperator(lex, '+') || isOperator(lex, '-');
+}
+
+ExpressionNode makeNode(ExpressionNodeType type, const Lexeme& lex)
+{
+    return ExpressionNode{type, lex.value, boost::string_view(),
+            InvalidExpressionNodeIndex, InvalidExpressionNodeIndex, 0, lex.offset};
+}
+
+/// Replaces operation on number literals with its result. Operands are the last nodes of the tree,
+/// since they were parsed right before the operation.
+bool tryFoldConstant(ExpressionTree& tree, const ExpressionNode& node, ExpressionNodeIndex& result)
+{
+    Constant operands[2];
+    ExpressionNodeIndex child = node.firstChild;
+    for (uint32_t i = 0; i < node.childCount; ++i, child = tree.getNode(child).nextSibling)
+    {
+        const ExpressionNode& operand = tree.getNode(child);
+        if (operand.type != EXPRESSION_NUMBER || !parseConstant(operand.value, operands[i]))
+        {
+            return false;
+        }
+    }
+
+    Constant value{};
+    const bool isFolded = (node.childCount == 1)
+            ? foldConstant(node.type, operands[0], value)
+            : foldConstant(node.type, operands[0], operands[1], value);
+    if (!isFolded)
+    {
+        return false;
+    }
+
+    std::string text;
+    writeConstant(value, text);
+    const size_t offset = (node.childCount == 1) ? node.offset : tree.getNode(node.firstChild).offset;
+
+    tree.truncate(node.firstChild);
+    result = tree.addNode(ExpressionNode{EXPRESSION_NUMBER, tree.addText(std::move(text)), boost::string_view(),
+            InvalidExpressionNodeIndex, InvalidExpressionNodeIndex, 0, offset});
+
+    return true;
+}
+
+ExpressionNodeIndex addOperationNode(ExpressionTree& tree, const ExpressionNode& node)
+{
+    ExpressionNodeIndex result = InvalidExpressionNodeIndex;
+    if (tryFoldConstant(tree, node, result))
+    {
+        return result;
+    }
+
+    return tree.addNode(node);
+}
+
+ExpressionNodeIndex addBinaryNode(ExpressionTree& tree, ExpressionNodeType type, const Lexeme& op,
+        ExpressionNodeIndex left, ExpressionNodeIndex right)
+{
+    tree.getNode(left).nextSibling = right;
+
+    ExpressionNode node = makeNode(type, op);
+    node.firstChild = left;
+    node.childCount = 2;
+
+    return addOperationNode(tree, node);
+}
+
+} // namespace
+
+const size_t ExpressionParser::MaxDepth;
+
+ExpressionParser::ExpressionParser(boost::string_view input, const ParseLimits& limits, bool allowInputs)
+    : lexer(input, limits),
+      current(lexer.getNextLexeme()),
+      next{boost::string_view(), LEX_END_OF_INPUT, 0},
+      hasNext(false),
+      previousLexemeEnd(0),
+      allowInputs(allowInputs)
+{}
+
+ExpressionParser::~ExpressionParser()
+{}
+
+const Lexeme& ExpressionParser::peekLexeme()
+{
+    if (!hasNext)
+    {
+        next = lexer.getNextLexeme();
+        hasNext = true;
+    }
+
+    return next;
+}
+
+void ExpressionParser::nextLexeme()
+{
+    previousLexemeEnd = current.offset + current.value.size();
+    if (hasNext)
+    {
+        current = next;
+        hasNext = false;
+    }
+    else
+    {
+        current = lexer.getNextLexeme();
+    }
+}
+
+ParseError ExpressionParser::makeError(ParseErrorCode code) const
+{
+    if (current.type == LEX_ERROR)
+    {
+        return ParseError{lexer.getError(), current.offset};
+    }
+
+    return ParseError{code, current.offset};
+}
+
+ParseError ExpressionParser::parseArgumentName(Lexeme& name, bool& hasNamedParameters, bool allowPlaceholders)
+{
+    // Name followed by '(' starts a nested call, which is a positional argument.
+    if (current.type == LEX_NAME && peekLexeme().type != LEX_LEFT_PARENTHESIS)
+    {
+        name = current;
+        hasNamedParameters = true;
+
+        nextLexeme();
+        if (!isOperator(current, '='))
+        {
+            return makeError(PARSE_ERROR_EXPECTED_ASSIGNMENT);
+        }
+        nextLexeme();
+
+        return NoError;
+    }
+
+    name = Lexeme{boost::string_view(), LEX_NAME, current.offset};
+    const bool isPlaceholder = (allowPlaceholders || allowInputs) && isQuestionMark(current);
+    if (hasNamedParameters && (canStartExpression(current) || isPlaceholder))
+    {
+        return makeError(PARSE_ERROR_POSITIONAL_AFTER_NAMED);
+    }
+
+    return NoError;
+}
+
+ParseError ExpressionParser::parseArgumentSeparator()
+{
+    if (isComma(current))
+    {
+        // skip to the next argument, which must be present.
+        nextLexeme();
+        if (current.type == LEX_RIGHT_PARENTHESIS)
+        {
+            return makeError(PARSE_ERROR_EXPECTED_VALUE);
+        }
+    }
+    else if (current.type != LEX_RIGHT_PARENTHESIS)
+    {
+        return makeError(PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS);
+    }
+
+    return NoError;
+}
+
+ParseError ExpressionParser::parseExpression(ExpressionTree& tree, ExpressionNodeIndex& result)
+{
+    return parseAdditive(tree, result, 0);
+}
+
+ParseError ExpressionParser::parseAdditive(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth)
+{
+    ParseError error = parseMultiplicative(tree, result, depth);
+    while (error.code == PARSE_ERROR_NONE && (isOperator(current, '+') || isOperator(current, '-')))
+    {
+        const Lexeme op = current;
+        nextLexeme();
+
+        ExpressionNodeIndex right = InvalidExpressionNodeIndex;
+        error = parseMultiplicative(tree, right, depth);
+        if (error.code == PARSE_ERROR_NONE)
+        {
+            result = addBinaryNode(tree, op.value[0] == '+' ? EXPRESSION_ADD : EXPRESSION_SUBTRACT,
+                    op, result, right);
+        }
+    }
+
+    return error;
+}
+
+ParseError ExpressionParser::parseMultiplicative(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth)
+{
+    ParseError error = parseUnary(tree, result, depth);
+    while (error.code == PARSE_ERROR_NONE && (isOperator(current, '*') || isOperator(current, '/')))
+    {
+        const Lexeme op = current;
+        nextLexeme();
+
+        ExpressionNodeIndex right = InvalidExpressionNodeIndex;
+        error = parseUnary(tree, right, depth);
+        if (error.code == PARSE_ERROR_NONE)
+        {
+            result = addBinaryNode(tree, op.value[0] == '*' ? EXPRESSION_MULTIPLY : EXPRESSION_DIVIDE,
+                    op, result, right);
+        }
+    }
+
+    return error;
+}
+
+ParseError ExpressionParser::parseUnary(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth)
+{
+    if (depth > MaxDepth)
+    {
+        return makeError(PARSE_ERROR_NESTING_TOO_DEEP);
+    }
+
+    if (isOperator(current, '+'))
+    {
+        // Unary plus is a no-op.
+        nextLexeme();
+        return parseUnary(tree, result, depth + 1);
+    }
+
+    if (isOperator(current, '-'))
+    {
+        const Lexeme op = current;
+        nextLexeme();
+
+        ExpressionNodeIndex operand = InvalidExpressionNodeIndex;
+        const ParseError error = parseUnary(tree, operand, depth + 1);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+
+        ExpressionNode node = makeNode(EXPRESSION_NEGATE, op);
+        node.firstChild = operand;
+        node.childCount = 1;
+        result = addOperationNode(tree, node);
+
+        return NoError;
+    }
+
+    return parsePrimary(tree, result, depth);
+}
+
+ParseError ExpressionParser::parsePrimary(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth)
+{
+    switch (current.type)
+    {
+        case LEX_NUMBER_LITERAL:
+            result = tree.addNode(makeNode(EXPRESSION_NUMBER, current));
+            nextLexeme();
+            return NoError;
+        case LEX_STRING_LITERAL:
+            result = tree.addNode(makeNode(EXPRESSION_STRING, current));
+            nextLexeme();
+            return NoError;
+        case LEX_NAME:
+            return parseCall(tree, result, depth + 1);
+        case LEX_PUNCTUATION:
+            if (!isInput(current))
+            {
+                return makeError(PARSE_ERROR_EXPECTED_VALUE);
+            }
+            result = tree.addNode(makeNode(EXPRESSION_INPUT, current));
+            nextLexeme();
+            return NoError;
+        case LEX_LEFT_PARENTHESIS:
+        {
+            nextLexeme();
+            const ParseError error = parseAdditive(tree, result, depth + 1);
+            if (error.code != PARSE_ERROR_NONE)
+            {
+                return error;
+            }
+            if (current.type != LEX_RIGHT_PARENTHESIS)
+            {
+                return makeError(PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS);
+            }
+            nextLexeme();
+
+            return NoError;
+        }
+        default:
+            return makeError(PARSE_ERROR_EXPECTED_VALUE);
+    }
+}
+
+ParseError ExpressionParser::parseCall(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth)
+{
+    if (depth > MaxDepth)
+    {
+        return makeError(PARSE_ERROR_NESTING_TOO_DEEP);
+    }
+
+    ExpressionNode call = makeNode(EXPRESSION_CALL, current);
+    nextLexeme();
+    if (current.type != LEX_LEFT_PARENTHESIS)
+    {
+        return makeError(PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS);
+    }
+
+    // parsing arguments, same rules as for top-level call.
+    ExpressionNodeIndex lastChild = InvalidExpressionNodeIndex;
+    bool hasNamedParameters = false;
+    nextLexeme();
+    while (current.type != LEX_RIGHT_PARENTHESIS)
+    {
+        Lexeme name;
+        ParseError error = parseArgumentName(name, hasNamedParameters);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+
+        ExpressionNodeIndex argument = InvalidExpressionNodeIndex;
+        error = parseAdditive(tree, argument, depth);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+        tree.getNode(argument).name = name.value;
+
+        if (lastChild == InvalidExpressionNodeIndex)
+        {
+            call.firstChild = argument;
+        }
+        else
+        {
+            tree.getNode(lastChild).nextSibling = argument;
+        }
+        lastChild = argument;
+        ++call.childCount;
+
+        error = parseArgumentSeparator();
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+    }
+    nextLexeme();
+
+    result = tree.addNode(call);
+
+    return NoError;
+}
+
+bool ExpressionParser::isInput(const Lexeme& lex) const
+{
+    return allowInputs && isQuestionMark(lex);
+}
+
+ExpressionTree::ExpressionTree()
+    : nodes(),
+      texts(),
+      root(InvalidExpressionNodeIndex)
+{}
+
+ExpressionTree::ExpressionTree(ExpressionTree&& other)
+    : nodes(std::move(other.nodes)),
+      texts(std::move(other.texts)),
+      root(other.root)
+{
+    other.root = InvalidExpressionNodeIndex;
+}
+
+ExpressionTree& ExpressionTree::operator=(ExpressionTree&& other)
+{
+    nodes = std::move(other.nodes);
+    texts = std::move(other.texts);
+    root = other.root;
+    other.root = InvalidExpressionNodeIndex;
+
+    return *this;
+}
+
+ExpressionTree::~ExpressionTree()
+{}
+
+ExpressionNodeIndex ExpressionTree::addNode(const ExpressionNode& node)
+{
+    nodes.push_back(node);
+
+    return static_cast<ExpressionNodeIndex>(nodes.size() - 1);
+}
+
+void ExpressionTree::truncate(size_t size)
+{
+    nodes.resize(size);
+}
+
+boost::string_view ExpressionTree::addText(std::string text)
+{
+    if (!texts)
+    {
+        texts.reset(new std::deque<std::string>);
+    }
+    texts->push_back(std::move(text));
+
+    return texts->back();
+}
+
+ExpressionNodeIndex ExpressionTree::getRoot() const
+{
+    return root;
+}
+
+void ExpressionTree::setRoot(ExpressionNodeIndex index)
+{
+    root = index;
+}
+
+size_t ExpressionTree::getSize() const
+{
+    return nodes.size();
+}
+
+void ExpressionTree::clear()
+{
+    nodes.clear();
+    if (texts)
+    {
+        texts->clear();
+    }
+    root = InvalidExpressionNodeIndex;
+}
+
+ParseResult<ExpressionTree> tryParseExpression(boost::string_view input, bool allowInputs)
+{
+    ExpressionParser parser(input, DefaultParseLimits, allowInputs);
+    ExpressionTree result;
+
+    ExpressionNodeIndex root = InvalidExpressionNodeIndex;
+    const ParseError error = parser.parseExpression(result, root);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+    if (parser.getLexeme().type != LEX_END_OF_INPUT)
+    {
+        return parser.makeError(PARSE_ERROR_TRAILING_INPUT);
+    }
+    result.setRoot(root);
+
+    return result;
+}
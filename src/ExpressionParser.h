@@ -0,0 +1,77 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_EXPRESSION_PARSER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_EXPRESSION_PARSER_H_INCLUDED
+
+#include "Expression.h"
+#include "Lexer.h"
+#include "ParseError.h"
+#include "StringView.h"
+
+#include <cstddef>
+
+/// Recursive descent parser of expressions over the Lexer, with a single lexeme lookahead.
+/// Also serves as a lexeme cursor for other parsers that allow expressions in some places.
+class ExpressionParser
+{
+public:
+    /// Max depth of nested calls, parentheses and unary operators.
+    static const size_t MaxDepth = 256;
+
+    /// Current lexeme is the first lexeme of the input.
+    /// If allowInputs is set, '?' in place of a value is parsed as EXPRESSION_INPUT.
+    explicit ExpressionParser(boost::string_view input, const ParseLimits& limits = DefaultParseLimits,
+            bool allowInputs = false);
+    ~ExpressionParser();
+
+    const Lexeme& getLexeme() const
+    {
+        return current;
+    }
+
+    /// Lexeme after the current one.
+    const Lexeme& peekLexeme();
+    void nextLexeme();
+
+    /// Error at the current lexeme, error from the Lexer takes precedence.
+    ParseError makeError(ParseErrorCode code) const;
+
+    /// Parses optional "name =" before an argument of a call. For positional arguments
+    /// name has empty value and offset of the argument. If allowPlaceholders is set,
+    /// '?' is a positional argument too, like in call templates.
+    ParseError parseArgumentName(Lexeme& name, bool& hasNamedParameters, bool allowPlaceholders = false);
+    /// Parses ',' before next argument or stops at ')'.
+    ParseError parseArgumentSeparator();
+
+    /// Parses expression that starts at current lexeme, adding nodes to the tree.
+    /// On success current lexeme is the first one after the expression.
+    ParseError parseExpression(ExpressionTree& tree, ExpressionNodeIndex& result);
+
+    /// Offset of the end of the last lexeme before the current one.
+    size_t getPreviousLexemeEnd() const
+    {
+        return previousLexemeEnd;
+    }
+
+private:
+    ParseError parseAdditive(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth);
+    ParseError parseMultiplicative(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth);
+    ParseError parseUnary(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth);
+    ParseError parsePrimary(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth);
+    /// Current lexeme is the function name.
+    ParseError parseCall(ExpressionTree& tree, ExpressionNodeIndex& result, size_t depth);
+    bool isInput(const Lexeme& lex) const;
+
+private:
+    Lexer lexer;
+    Lexeme current;
+    Lexeme next;
+    bool hasNext;
+    size_t previousLexemeEnd;
+    bool allowInputs;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_EXPRESSION_PARSER_H_INCLUDED
@@ -0,0 +1,562 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ExpressionProgram.h"
+
+#include "ArgumentConverter.h"
+#include "FunctionRegistry.h"
+#include "Lexer.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+
+// Programs with deeper stack allocate it on evaluation.
+const size_t LocalStackSize = 32;
+
+/// Default value of the spec parameter, false if it is not a literal.
+bool parseDefaultValue(const std::string& literal, ExpressionValueType& type, double& number, std::string& string)
+{
+    Lexer lexer(literal);
+    const Lexeme lex = lexer.getNextLexeme();
+    if (lexer.getNextLexeme().type != LEX_END_OF_INPUT)
+    {
+        return false;
+    }
+
+    if (lex.type == LEX_STRING_LITERAL)
+    {
+        type = EXPRESSION_VALUE_STRING;
+        return ArgumentConverter<std::string>::convert(lex, string);
+    }
+
+    type = EXPRESSION_VALUE_NUMBER;
+    return ArgumentConverter<double>::convert(lex, number);
+}
+
+/// Names and default values are the same, ids are ignored.
+bool isSameSpec(const RegisteredFunctionSpec& registered, const FunctionSpec& spec)
+{
+    if (registered.name != spec.name || registered.parameters.size() != spec.parameters.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < spec.parameters.size(); ++i)
+    {
+        const RegisteredFunctionSpecParameter& left = registered.parameters[i];
+        const FunctionSpecParameter& right = spec.parameters[i];
+        if (left.name != right.name || static_cast<bool>(left.value) != static_cast<bool>(right.value)
+                || (left.value && *left.value != *right.value))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+ExpressionFunctionTable::ExpressionFunctionTable()
+    : ownSymbols(new SymbolTable),
+      registry(nullptr),
+      symbols(ownSymbols.get())
+{}
+
+ExpressionFunctionTable::ExpressionFunctionTable(FunctionRegistry& registry)
+    : ownSymbols(),
+      registry(&registry),
+      symbols(&registry.getSymbolTable())
+{}
+
+ExpressionFunctionTable::~ExpressionFunctionTable()
+{}
+
+std::string ExpressionFunctionTable::addFunction(const std::string& functionSpecification, ExpressionFunction function)
+{
+    return addFunction(parseFunctionSpec(functionSpecification), std::move(function));
+}
+
+std::string ExpressionFunctionTable::addFunction(const FunctionSpec& spec, ExpressionFunction function)
+{
+    for (const auto& parameter : spec.parameters)
+    {
+        ExpressionValueType type;
+        double number = 0;
+        std::string string;
+        if (parameter.value && !parseDefaultValue(*parameter.value, type, number, string))
+        {
+            throw std::invalid_argument("Invalid default value of parameter \"" + parameter.name
+                    + "\" of function \"" + spec.name + "\"");
+        }
+    }
+
+    SymbolId nameId = InvalidSymbolId;
+    if (registry)
+    {
+        // Registry keeps the function it already has, which must be the same.
+        registry->addFunction(spec);
+        const RegisteredFunctionSpec* registered = registry->findFunctionSpecByName(spec.name);
+        if (!isSameSpec(*registered, spec))
+        {
+            throw std::invalid_argument("Function \"" + spec.name + "\" is registered with a different spec");
+        }
+        nameId = symbols->find(spec.name);
+    }
+    else
+    {
+        nameId = ownSymbols->intern(spec.name);
+    }
+
+    std::shared_ptr<const ExpressionFunctionEntry> entry(new ExpressionFunctionEntry{spec, std::move(function)});
+    if (entries.size() <= nameId)
+    {
+        entries.resize(nameId + 1);
+    }
+    entries[nameId] = std::move(entry);
+
+    return spec.name;
+}
+
+std::shared_ptr<const ExpressionFunctionEntry> ExpressionFunctionTable::findFunction(boost::string_view name) const
+{
+    return findFunction(symbols->find(name));
+}
+
+std::shared_ptr<const ExpressionFunctionEntry> ExpressionFunctionTable::findFunction(SymbolId nameId) const
+{
+    if (nameId >= entries.size())
+    {
+        return nullptr;
+    }
+
+    return entries[nameId];
+}
+
+const SymbolTable& ExpressionFunctionTable::getSymbolTable() const
+{
+    return *symbols;
+}
+
+/// Emits code of the subtree in post-order, tracking stack depth.
+class ExpressionCompiler
+{
+public:
+    ExpressionCompiler(const ExpressionTree& tree, const ExpressionFunctionTable& table, ExpressionProgram& program)
+        : tree(tree),
+          table(table),
+          program(program),
+          stackDepth(0)
+    {
+        // Leaves are added to the tree as they are parsed, so inputs are numbered in order of appearance.
+        for (size_t index = 0; index < tree.getSize(); ++index)
+        {
+            if (tree.getNode(static_cast<ExpressionNodeIndex>(index)).type == EXPRESSION_INPUT)
+            {
+                inputIndices.resize(tree.getSize());
+                inputIndices[index] = static_cast<uint32_t>(program.inputCount++);
+            }
+        }
+    }
+
+    ParseError compile(ExpressionNodeIndex index, ExpressionValueType& type)
+    {
+        const ExpressionNode& node = tree.getNode(index);
+        switch (node.type)
+        {
+            case EXPRESSION_NUMBER:
+            {
+                double value = 0;
+                if (!ArgumentConverter<double>::convert(Lexeme{node.value, LEX_NUMBER_LITERAL, node.offset}, value))
+                {
+                    return ParseError{PARSE_ERROR_INVALID_NUMBER, node.offset};
+                }
+                type = EXPRESSION_VALUE_NUMBER;
+                emitPushNumber(value);
+                return ParseError{PARSE_ERROR_NONE, 0};
+            }
+            case EXPRESSION_STRING:
+                type = EXPRESSION_VALUE_STRING;
+                emitPushString(unescapeStringLiteral(node.value));
+                return ParseError{PARSE_ERROR_NONE, 0};
+            case EXPRESSION_INPUT:
+                // Type is known on evaluation, see compileOperator().
+                type = EXPRESSION_VALUE_NUMBER;
+                emit(OPCODE_LOAD_INPUT, inputIndices[index], 1);
+                return ParseError{PARSE_ERROR_NONE, 0};
+            case EXPRESSION_CALL:
+                type = EXPRESSION_VALUE_NUMBER;
+                return compileCall(node);
+            case EXPRESSION_NEGATE:
+            case EXPRESSION_ADD:
+            case EXPRESSION_SUBTRACT:
+            case EXPRESSION_MULTIPLY:
+            case EXPRESSION_DIVIDE:
+                type = EXPRESSION_VALUE_NUMBER;
+                return compileOperator(node);
+        }
+
+        return ParseError{PARSE_ERROR_UNEXPECTED_CHARACTER, node.offset};
+    }
+
+    void emit(ExpressionOpcode opcode, uint32_t operand, int stackEffect)
+    {
+        program.code.push_back(ExpressionInstruction{opcode, operand});
+        stackDepth = static_cast<size_t>(static_cast<ptrdiff_t>(stackDepth) + stackEffect);
+        if (stackDepth > program.stackSize)
+        {
+            program.stackSize = stackDepth;
+        }
+    }
+
+private:
+    ParseError compileOperator(const ExpressionNode& node)
+    {
+        ExpressionNodeIndex child = node.firstChild;
+        for (uint32_t i = 0; i < node.childCount; ++i, child = tree.getNode(child).nextSibling)
+        {
+            ExpressionValueType childType = EXPRESSION_VALUE_NUMBER;
+            const ParseError error = compile(child, childType);
+            if (error.code != PARSE_ERROR_NONE)
+            {
+                return error;
+            }
+            if (childType != EXPRESSION_VALUE_NUMBER)
+            {
+                return ParseError{PARSE_ERROR_INVALID_ARGUMENT_TYPE, tree.getNode(child).offset};
+            }
+            if (tree.getNode(child).type == EXPRESSION_INPUT)
+            {
+                program.numberInputs.push_back(inputIndices[child]);
+            }
+        }
+
+        static const ExpressionOpcode Opcodes[] = {OPCODE_NEGATE, OPCODE_ADD, OPCODE_SUBTRACT, OPCODE_MULTIPLY,
+                OPCODE_DIVIDE};
+        emit(Opcodes[node.type - EXPRESSION_NEGATE], 0, (node.childCount == 1) ? 0 : -1);
+
+        return ParseError{PARSE_ERROR_NONE, 0};
+    }
+
+    ParseError compileCall(const ExpressionNode& node)
+    {
+        std::shared_ptr<const ExpressionFunctionEntry> function = table.findFunction(node.value);
+        if (!function)
+        {
+            return ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, node.offset};
+        }
+
+        // Argument node of each spec parameter.
+        const FunctionSpecParameters& parameters = function->spec.parameters;
+        std::vector<ExpressionNodeIndex> arguments(parameters.size(), InvalidExpressionNodeIndex);
+
+        size_t position = 0;
+        for (ExpressionNodeIndex child = node.firstChild; child != InvalidExpressionNodeIndex;
+                child = tree.getNode(child).nextSibling, ++position)
+        {
+            const ExpressionNode& argument = tree.getNode(child);
+            size_t slot = position;
+            if (!argument.name.empty())
+            {
+                for (slot = 0; slot < parameters.size() && parameters[slot].name != argument.name; ++slot)
+                {}
+                if (slot == parameters.size())
+                {
+                    return ParseError{PARSE_ERROR_UNKNOWN_PARAMETER, argument.offset};
+                }
+            }
+            else if (slot >= parameters.size())
+            {
+                return ParseError{PARSE_ERROR_TOO_MANY_PARAMETERS, argument.offset};
+            }
+
+            if (arguments[slot] != InvalidExpressionNodeIndex)
+            {
+                return ParseError{PARSE_ERROR_DUPLICATE_PARAMETER, argument.offset};
+            }
+            arguments[slot] = child;
+        }
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            if (arguments[i] != InvalidExpressionNodeIndex)
+            {
+                ExpressionValueType type = EXPRESSION_VALUE_NUMBER;
+                const ParseError error = compile(arguments[i], type);
+                if (error.code != PARSE_ERROR_NONE)
+                {
+                    return error;
+                }
+                continue;
+            }
+
+            if (!parameters[i].value)
+            {
+                return ParseError{PARSE_ERROR_MISSING_PARAMETER, node.offset};
+            }
+
+            // Validated by addFunction().
+            ExpressionValueType type = EXPRESSION_VALUE_NUMBER;
+            double number = 0;
+            std::string string;
+            parseDefaultValue(*parameters[i].value, type, number, string);
+            if (type == EXPRESSION_VALUE_NUMBER)
+            {
+                emitPushNumber(number);
+            }
+            else
+            {
+                emitPushString(std::move(string));
+            }
+        }
+
+        emit(OPCODE_CALL, addFunction(std::move(function)), 1 - static_cast<int>(parameters.size()));
+
+        return ParseError{PARSE_ERROR_NONE, 0};
+    }
+
+    void emitPushNumber(double value)
+    {
+        program.numbers.push_back(value);
+        emit(OPCODE_PUSH_NUMBER, static_cast<uint32_t>(program.numbers.size() - 1), 1);
+    }
+
+    void emitPushString(std::string value)
+    {
+        program.strings.push_back(std::move(value));
+        emit(OPCODE_PUSH_STRING, static_cast<uint32_t>(program.strings.size() - 1), 1);
+    }
+
+    uint32_t addFunction(std::shared_ptr<const ExpressionFunctionEntry> function)
+    {
+        for (size_t i = 0; i < program.functions.size(); ++i)
+        {
+            if (program.functions[i] == function)
+            {
+                return static_cast<uint32_t>(i);
+            }
+        }
+
+        program.argumentCounts.push_back(function->spec.parameters.size());
+        program.functions.push_back(std::move(function));
+        return static_cast<uint32_t>(program.functions.size() - 1);
+    }
+
+private:
+    const ExpressionTree& tree;
+    const ExpressionFunctionTable& table;
+    ExpressionProgram& program;
+    size_t stackDepth;
+    // Indexed by node index, set for EXPRESSION_INPUT nodes only.
+    std::vector<uint32_t> inputIndices;
+};
+
+ExpressionProgram::ExpressionProgram()
+    : stackSize(0),
+      inputCount(0)
+{}
+
+ExpressionProgram::~ExpressionProgram()
+{}
+
+ExpressionValue ExpressionProgram::evaluate(const ExpressionValue* inputs, size_t inputCount) const
+{
+    if (stackSize <= LocalStackSize)
+    {
+        ExpressionValue stack[LocalStackSize];
+        return evaluate(inputs, inputCount, stack);
+    }
+
+    std::vector<ExpressionValue> stack(stackSize);
+    return evaluate(inputs, inputCount, stack.data());
+}
+
+ExpressionValue ExpressionProgram::evaluate(const ExpressionValue* inputs, size_t inputCount,
+        ExpressionValue* stack) const
+{
+    checkInputs(inputs, inputCount);
+    return run(inputs, stack);
+}
+
+ExpressionValue ExpressionProgram::evaluate() const
+{
+    return evaluate(nullptr, 0);
+}
+
+ExpressionValue ExpressionProgram::evaluate(ExpressionValue* stack) const
+{
+    return evaluate(nullptr, 0, stack);
+}
+
+void ExpressionProgram::checkInputs(const ExpressionValue* inputs, size_t inputCount) const
+{
+    if (inputCount != this->inputCount)
+    {
+        throw std::invalid_argument("Expression has " + std::to_string(this->inputCount) + " inputs, "
+                + std::to_string(inputCount) + " given");
+    }
+
+    for (const uint32_t index : numberInputs)
+    {
+        if (inputs[index].type != EXPRESSION_VALUE_NUMBER)
+        {
+            throw std::invalid_argument("Input " + std::to_string(index) + " of expression must be a number");
+        }
+    }
+}
+
+// Labels as values make a jump table that dispatches to the next handler from the end
+// of each handler, which predicts better than a single switch. It is a GNU extension.
+#if defined(__GNUC__)
+#   define EQUEUM_EXPRESSION_COMPUTED_GOTO 1
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wpedantic"
+#else
+#   define EQUEUM_EXPRESSION_COMPUTED_GOTO 0
+#endif
+
+#if EQUEUM_EXPRESSION_COMPUTED_GOTO
+#   define EXPRESSION_VM_CASE(opcode) LABEL_##opcode
+#   define EXPRESSION_VM_DISPATCH() goto *Labels[instruction->opcode]
+#else
+#   define EXPRESSION_VM_CASE(opcode) case opcode
+#   define EXPRESSION_VM_DISPATCH() goto dispatch
+#endif
+
+ExpressionValue ExpressionProgram::run(const ExpressionValue* inputs, ExpressionValue* stack) const
+{
+    // Points past the top value.
+    ExpressionValue* top = stack;
+    const ExpressionInstruction* instruction = code.data();
+
+#if EQUEUM_EXPRESSION_COMPUTED_GOTO
+    // In ExpressionOpcode order.
+    static const void* const Labels[] =
+    {
+        &&LABEL_OPCODE_PUSH_NUMBER,
+        &&LABEL_OPCODE_PUSH_STRING,
+        &&LABEL_OPCODE_LOAD_INPUT,
+        &&LABEL_OPCODE_NEGATE,
+        &&LABEL_OPCODE_ADD,
+        &&LABEL_OPCODE_SUBTRACT,
+        &&LABEL_OPCODE_MULTIPLY,
+        &&LABEL_OPCODE_DIVIDE,
+        &&LABEL_OPCODE_CALL,
+        &&LABEL_OPCODE_RETURN,
+    };
+    EXPRESSION_VM_DISPATCH();
+#else
+dispatch:
+    switch (instruction->opcode)
+#endif
+    {
+        EXPRESSION_VM_CASE(OPCODE_PUSH_NUMBER):
+            top->type = EXPRESSION_VALUE_NUMBER;
+            top->number = numbers[instruction->operand];
+            ++top;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_PUSH_STRING):
+            top->type = EXPRESSION_VALUE_STRING;
+            top->string = strings[instruction->operand];
+            ++top;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_LOAD_INPUT):
+            *top = inputs[instruction->operand];
+            ++top;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_NEGATE):
+            top[-1].number = -top[-1].number;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_ADD):
+            --top;
+            top[-1].number += top->number;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_SUBTRACT):
+            --top;
+            top[-1].number -= top->number;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_MULTIPLY):
+            --top;
+            top[-1].number *= top->number;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_DIVIDE):
+            --top;
+            top[-1].number /= top->number;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+
+        EXPRESSION_VM_CASE(OPCODE_CALL):
+        {
+            const size_t argumentCount = argumentCounts[instruction->operand];
+            top -= argumentCount;
+            const double result = functions[instruction->operand]->function(top, argumentCount);
+            top->type = EXPRESSION_VALUE_NUMBER;
+            top->number = result;
+            ++top;
+            ++instruction;
+            EXPRESSION_VM_DISPATCH();
+        }
+
+        EXPRESSION_VM_CASE(OPCODE_RETURN):
+            return top[-1];
+    }
+
+    // Not reached, every handler either dispatches or returns.
+    return top[-1];
+}
+
+#undef EXPRESSION_VM_CASE
+#undef EXPRESSION_VM_DISPATCH
+
+#if EQUEUM_EXPRESSION_COMPUTED_GOTO
+#   pragma GCC diagnostic pop
+#endif
+
+ParseResult<ExpressionProgram> compileExpression(const ExpressionTree& tree,
+        const ExpressionFunctionTable& functions)
+{
+    ExpressionProgram program;
+    ExpressionCompiler compiler(tree, functions, program);
+
+    ExpressionValueType type = EXPRESSION_VALUE_NUMBER;
+    const ParseError error = compiler.compile(tree.getRoot(), type);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+    compiler.emit(OPCODE_RETURN, 0, 0);
+
+    return program;
+}
+
+ParseResult<ExpressionProgram> compileExpression(boost::string_view input,
+        const ExpressionFunctionTable& functions)
+{
+    const ParseResult<ExpressionTree> tree = tryParseExpression(input, true);
+    if (!tree)
+    {
+        return tree.getError();
+    }
+
+    return compileExpression(tree.getValue(), functions);
+}
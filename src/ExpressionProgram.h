@@ -0,0 +1,168 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_EXPRESSION_PROGRAM_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_EXPRESSION_PROGRAM_H_INCLUDED
+
+#include "Expression.h"
+#include "FunctionParser.h"
+#include "ParseError.h"
+#include "StringView.h"
+#include "SymbolTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class FunctionRegistry;
+
+enum ExpressionValueType : int
+{
+    EXPRESSION_VALUE_NUMBER,
+    EXPRESSION_VALUE_STRING,
+};
+
+/// Value on the evaluation stack.
+struct ExpressionValue
+{
+    ExpressionValueType type;
+    double number; // valid only for EXPRESSION_VALUE_NUMBER
+    boost::string_view string; // unescaped, points into the program, valid only for EXPRESSION_VALUE_STRING
+};
+
+/// Native function called by programs, arguments are in spec parameter order with defaults applied.
+typedef std::function<double (const ExpressionValue* arguments, size_t argumentCount)> ExpressionFunction;
+
+struct ExpressionFunctionEntry
+{
+    FunctionSpec spec;
+    ExpressionFunction function;
+};
+
+/// Functions that programs can call, looked up by name at compile time only.
+/// Concurrent compileExpression() calls are safe as long as nobody calls addFunction().
+class ExpressionFunctionTable
+{
+public:
+    /// Names are interned into a symbol table of its own.
+    ExpressionFunctionTable();
+    /// Functions are also added to the registry and names are resolved through its symbol table,
+    /// so ids of calls parsed with registry.getSymbolTable() can be passed to findFunction().
+    /// Registry must outlive the table.
+    explicit ExpressionFunctionTable(FunctionRegistry& registry);
+    ~ExpressionFunctionTable();
+
+    /// Replaces function with the same name, programs compiled before keep calling the old one.
+    /// Throws ParseException on malformed spec and std::invalid_argument on default value
+    /// that is neither number nor string literal, or on spec that differs from the one
+    /// already registered in the registry under the same name.
+    std::string addFunction(const std::string& functionSpecification, ExpressionFunction function);
+    std::string addFunction(const FunctionSpec& spec, ExpressionFunction function);
+
+    /// nullptr if there is no such function.
+    std::shared_ptr<const ExpressionFunctionEntry> findFunction(boost::string_view name) const;
+    /// Same as above, nameId is from getSymbolTable().
+    std::shared_ptr<const ExpressionFunctionEntry> findFunction(SymbolId nameId) const;
+
+    /// Symbol table of the registry or of the table itself.
+    const SymbolTable& getSymbolTable() const;
+
+private:
+    // Set when the table is created without a registry.
+    std::unique_ptr<SymbolTable> ownSymbols;
+    FunctionRegistry* registry;
+    const SymbolTable* symbols;
+    // Indexed by SymbolId of the function name, nullptr for unknown names.
+    std::vector<std::shared_ptr<const ExpressionFunctionEntry>> entries;
+};
+
+enum ExpressionOpcode : uint8_t
+{
+    OPCODE_PUSH_NUMBER, // operand is index of the number constant
+    OPCODE_PUSH_STRING, // operand is index of the string constant
+    OPCODE_LOAD_INPUT, // operand is index of the input
+    OPCODE_NEGATE,
+    OPCODE_ADD,
+    OPCODE_SUBTRACT,
+    OPCODE_MULTIPLY,
+    OPCODE_DIVIDE,
+    OPCODE_CALL, // operand is index of the function, replaces its arguments with the result
+    OPCODE_RETURN, // returns the top of the stack
+};
+
+struct ExpressionInstruction
+{
+    ExpressionOpcode opcode;
+    uint32_t operand;
+};
+
+/// Expression lowered to stack machine bytecode, with calls resolved to functions
+/// and arguments reordered to spec order, so evaluation does no lookups.
+/// Compile once and evaluate many times: programs are immutable, cheap to copy and
+/// can be evaluated concurrently. Arithmetic is done in double.
+/// Each '?' in the expression is an input, given to evaluate() in order of appearance.
+class ExpressionProgram
+{
+public:
+    ExpressionProgram();
+    ~ExpressionProgram();
+
+    /// Exceptions thrown by functions are propagated. Throws std::invalid_argument
+    /// if inputCount is not getInputCount() or if input used as an operand of arithmetic
+    /// is not a number. String result may point into inputs.
+    ExpressionValue evaluate(const ExpressionValue* inputs, size_t inputCount) const;
+    /// Same as above, but with caller-provided stack of at least getStackSize() values.
+    ExpressionValue evaluate(const ExpressionValue* inputs, size_t inputCount, ExpressionValue* stack) const;
+    /// For programs without inputs.
+    ExpressionValue evaluate() const;
+    ExpressionValue evaluate(ExpressionValue* stack) const;
+
+    size_t getStackSize() const
+    {
+        return stackSize;
+    }
+
+    size_t getInputCount() const
+    {
+        return inputCount;
+    }
+
+    const std::vector<ExpressionInstruction>& getCode() const
+    {
+        return code;
+    }
+
+private:
+    friend class ExpressionCompiler;
+
+    void checkInputs(const ExpressionValue* inputs, size_t inputCount) const;
+    ExpressionValue run(const ExpressionValue* inputs, ExpressionValue* stack) const;
+
+private:
+    std::vector<ExpressionInstruction> code;
+    std::vector<double> numbers;
+    std::vector<std::string> strings;
+    // Argument counts are copied from specs to avoid an indirection per call.
+    std::vector<std::shared_ptr<const ExpressionFunctionEntry>> functions;
+    std::vector<size_t> argumentCounts;
+    size_t stackSize;
+    size_t inputCount;
+    // Inputs that are operands of arithmetic, their types are known only on evaluation.
+    std::vector<uint32_t> numberInputs;
+};
+
+/// Errors are reported at offsets of tree nodes: unknown function or parameter,
+/// duplicate, missing or extra arguments and string operands of arithmetic operators.
+/// Arguments are evaluated in spec parameter order, not in the order they are written.
+/// Input string is parsed with '?' inputs allowed.
+ParseResult<ExpressionProgram> compileExpression(const ExpressionTree& tree,
+        const ExpressionFunctionTable& functions);
+ParseResult<ExpressionProgram> compileExpression(boost::string_view input,
+        const ExpressionFunctionTable& functions);
+
+#endif // EQUEUM_FUNCTION_PARSER_EXPRESSION_PROGRAM_H_INCLUDED
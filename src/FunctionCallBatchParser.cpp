@@ -0,0 +1,114 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallBatchParser.h"
+
+#include "ParserContext.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+
+// Ranges that are split further, per thread. Big enough to let thieves find work,
+// small enough to keep the overhead of spawning tasks negligible.
+const size_t RangesPerThread = 16;
+
+struct BatchState
+{
+    BatchState(const std::vector<boost::string_view>& inputs, size_t grainSize)
+        : inputs(inputs),
+          results(inputs.size(), ParseResult<FunctionCall>(FunctionCall{})),
+          grainSize(grainSize),
+          remaining(inputs.size())
+    {}
+
+    const std::vector<boost::string_view>& inputs;
+    std::vector<ParseResult<FunctionCall>> results;
+    const size_t grainSize;
+
+    std::atomic<size_t> remaining;
+    std::promise<void> done;
+
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+};
+
+void markDone(BatchState& state, size_t count)
+{
+    if (state.remaining.fetch_sub(count) == count)
+    {
+        state.done.set_value();
+    }
+}
+
+void parseRange(ThreadPool& pool, const std::shared_ptr<BatchState>& state, size_t begin, size_t end)
+{
+    // Leave the upper half to be stolen, keep on splitting the lower one.
+    while (end - begin > state->grainSize)
+    {
+        const size_t middle = begin + (end - begin) / 2;
+        pool.post([&pool, state, middle, end]()
+        {
+            parseRange(pool, state, middle, end);
+        });
+        end = middle;
+    }
+
+    try
+    {
+        ParserContext context;
+        for (size_t i = begin; i < end; ++i)
+        {
+            context.reset(state->inputs[i]);
+            state->results[i] = context.parseCall();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(state->exceptionMutex);
+        if (!state->exception)
+        {
+            state->exception = std::current_exception();
+        }
+    }
+
+    markDone(*state, end - begin);
+}
+
+} // namespace
+
+std::vector<ParseResult<FunctionCall>> parseFunctionCalls(
+        const std::vector<boost::string_view>& inputs, ThreadPool& pool)
+{
+    if (inputs.empty())
+    {
+        return std::vector<ParseResult<FunctionCall>>();
+    }
+
+    const size_t grainSize = std::max<size_t>(1,
+            inputs.size() / (pool.getThreadCount() * RangesPerThread));
+    const auto state = std::make_shared<BatchState>(inputs, grainSize);
+
+    std::future<void> done = state->done.get_future();
+    pool.post([&pool, state]()
+    {
+        parseRange(pool, state, 0, state->inputs.size());
+    });
+    done.wait();
+
+    if (state->exception)
+    {
+        std::rethrow_exception(state->exception);
+    }
+
+    return std::move(state->results);
+}
@@ -0,0 +1,23 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_BATCH_PARSER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_BATCH_PARSER_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "StringView.h"
+
+#include <vector>
+
+class ThreadPool;
+
+/// Parses every input with tryParseFunctionCall on the pool, results are in input order.
+/// Inputs are split recursively, halves are left for idle workers to steal,
+/// so inputs of uneven length keep all threads busy.
+/// Must not be called from the pool's own tasks.
+std::vector<ParseResult<FunctionCall>> parseFunctionCalls(
+        const std::vector<boost::string_view>& inputs, ThreadPool& pool);
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_BATCH_PARSER_H_INCLUDED
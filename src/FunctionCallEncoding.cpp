@@ -0,0 +1,447 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallEncoding.h"
+
+#include <limits>
+
+namespace
+{
+
+// Version 1 guessed value types from the text, so expressions could pass for literals.
+const uint8_t EncodingVersion = 2;
+const uint8_t ParameterValueTypeMask = 0x3;
+const uint8_t ParameterHasName = 0x4;
+
+// Max number of bytes in varint-encoded uint64_t.
+const size_t MaxVarintSize = 10;
+
+void appendVarint(std::string& output, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+
+void appendBytes(std::string& output, boost::string_view bytes)
+{
+    appendVarint(output, bytes.size());
+    output.append(bytes.data(), bytes.size());
+}
+
+void appendName(std::string& output, boost::string_view name, SymbolId nameId, FunctionCallEncodingNames names)
+{
+    if (names == ENCODE_NAME_IDS && nameId != InvalidSymbolId)
+    {
+        appendVarint(output, (static_cast<uint64_t>(nameId) << 1) | 1);
+    }
+    else
+    {
+        appendVarint(output, static_cast<uint64_t>(name.size()) << 1);
+        output.append(name.data(), name.size());
+    }
+}
+
+/// Returns false if value is not a canonical non-negative integer that fits uint64_t.
+bool tryParseInteger(boost::string_view value, uint64_t& result)
+{
+    if (value.empty() || (value[0] == '0' && value.size() > 1))
+    {
+        return false;
+    }
+
+    const uint64_t maxValue = std::numeric_limits<uint64_t>::max();
+    result = 0;
+    for (const char c : value)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+
+        const uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (result > (maxValue - digit) / 10)
+        {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+
+    return true;
+}
+
+EncodedValueType getEncodedValueType(const FunctionCallParameter& param, uint64_t& integer)
+{
+    switch (param.valueType)
+    {
+        case CALL_VALUE_NUMBER:
+            return tryParseInteger(param.value, integer) ? ENCODED_VALUE_INTEGER : ENCODED_VALUE_NUMBER;
+        case CALL_VALUE_STRING:
+            return ENCODED_VALUE_STRING;
+        case CALL_VALUE_EXPRESSION:
+            break;
+    }
+
+    return ENCODED_VALUE_EXPRESSION;
+}
+
+void appendValue(std::string& output, EncodedValueType valueType, uint64_t integer, boost::string_view value)
+{
+    switch (valueType)
+    {
+        case ENCODED_VALUE_INTEGER:
+            appendVarint(output, integer);
+            break;
+        case ENCODED_VALUE_NUMBER:
+        case ENCODED_VALUE_EXPRESSION:
+            appendBytes(output, value);
+            break;
+        case ENCODED_VALUE_STRING:
+            appendBytes(output, value.substr(1, value.size() - 2));
+            break;
+    }
+}
+
+/// Bounds-checked reader, once failed returns zeroes and empty views.
+class Reader
+{
+public:
+    /// begin is the start of the encoded data, for offsets.
+    Reader(const char* begin, const char* position, const char* end)
+        : begin(begin),
+          position(position),
+          end(end),
+          failed(false)
+    {}
+
+    uint8_t readByte()
+    {
+        if (failed || position == end)
+        {
+            return fail();
+        }
+
+        return static_cast<uint8_t>(*position++);
+    }
+
+    uint64_t readVarint()
+    {
+        uint64_t result = 0;
+        for (size_t i = 0; i < MaxVarintSize; ++i)
+        {
+            if (failed || position == end)
+            {
+                return fail();
+            }
+
+            const uint8_t byte = static_cast<uint8_t>(*position++);
+            if (i == MaxVarintSize - 1 && byte > 1)
+            {
+                // doesn't fit uint64_t
+                return fail();
+            }
+            result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0)
+            {
+                return result;
+            }
+        }
+
+        return fail();
+    }
+
+    boost::string_view readBytes(uint64_t size)
+    {
+        if (failed || size > static_cast<uint64_t>(end - position))
+        {
+            fail();
+            return boost::string_view();
+        }
+
+        const boost::string_view result(position, static_cast<size_t>(size));
+        position += size;
+
+        return result;
+    }
+
+    EncodedName readName()
+    {
+        const size_t offset = static_cast<size_t>(position - begin);
+        const uint64_t value = readVarint();
+        if ((value & 1) == 0)
+        {
+            return EncodedName{InvalidSymbolId, readBytes(value >> 1), offset};
+        }
+
+        const uint64_t id = value >> 1;
+        if (id == InvalidSymbolId || id > std::numeric_limits<SymbolId>::max())
+        {
+            fail();
+            return EncodedName{InvalidSymbolId, boost::string_view(), offset};
+        }
+
+        return EncodedName{static_cast<SymbolId>(id), boost::string_view(), offset};
+    }
+
+    void readParameter(EncodedParameter& parameter)
+    {
+        const uint8_t header = readByte();
+        if ((header & ~(ParameterValueTypeMask | ParameterHasName)) != 0
+                || (header & ParameterValueTypeMask) > ENCODED_VALUE_EXPRESSION)
+        {
+            fail();
+            return;
+        }
+
+        parameter.hasName = (header & ParameterHasName) != 0;
+        parameter.name = parameter.hasName ? readName() : EncodedName{InvalidSymbolId, boost::string_view(), 0};
+        parameter.valueType = static_cast<EncodedValueType>(header & ParameterValueTypeMask);
+        parameter.integer = 0;
+        parameter.text = boost::string_view();
+        if (parameter.valueType == ENCODED_VALUE_INTEGER)
+        {
+            parameter.integer = readVarint();
+        }
+        else
+        {
+            parameter.text = readBytes(readVarint());
+        }
+    }
+
+    bool isFailed() const
+    {
+        return failed;
+    }
+
+    const char* getPosition() const
+    {
+        return position;
+    }
+
+private:
+    uint8_t fail()
+    {
+        failed = true;
+        return 0;
+    }
+
+private:
+    const char* begin;
+    const char* position;
+    const char* end;
+    bool failed;
+};
+
+/// Returns false if name is encoded as id that symbols doesn't have.
+bool decodeName(const EncodedName& name, const SymbolTable* symbols, std::string& result, SymbolId& resultId)
+{
+    if (name.id == InvalidSymbolId)
+    {
+        result.assign(name.name.data(), name.name.size());
+        resultId = symbols ? symbols->find(name.name) : InvalidSymbolId;
+        return true;
+    }
+
+    if (!symbols || name.id > symbols->getSize())
+    {
+        return false;
+    }
+
+    const boost::string_view symbol = symbols->getName(name.id);
+    result.assign(symbol.data(), symbol.size());
+    resultId = name.id;
+    return true;
+}
+
+} // namespace
+
+void encodeFunctionCall(const FunctionCall& call, std::string& output, FunctionCallEncodingNames names)
+{
+    output.push_back(static_cast<char>(EncodingVersion));
+    appendName(output, call.name, call.nameId, names);
+    appendVarint(output, call.parameters.size());
+
+    for (const auto& param : call.parameters)
+    {
+        uint64_t integer = 0;
+        const EncodedValueType valueType = getEncodedValueType(param, integer);
+        output.push_back(static_cast<char>(valueType | (param.name ? ParameterHasName : 0)));
+        if (param.name)
+        {
+            appendName(output, *param.name, param.nameId, names);
+        }
+        appendValue(output, valueType, integer, param.value);
+    }
+}
+
+std::string encodeFunctionCall(const FunctionCall& call, FunctionCallEncodingNames names)
+{
+    std::string result;
+    encodeFunctionCall(call, result, names);
+
+    return result;
+}
+
+EncodedFunctionCallView::ParameterIterator::ParameterIterator()
+    : begin(nullptr),
+      position(nullptr),
+      end(nullptr),
+      remaining(0),
+      parameter()
+{}
+
+EncodedFunctionCallView::ParameterIterator::ParameterIterator(const char* begin, const char* position,
+        const char* end, size_t remaining)
+    : begin(begin),
+      position(position),
+      end(end),
+      remaining(remaining),
+      parameter()
+{
+    read();
+}
+
+EncodedFunctionCallView::ParameterIterator& EncodedFunctionCallView::ParameterIterator::operator++()
+{
+    --remaining;
+    read();
+
+    return *this;
+}
+
+EncodedFunctionCallView::ParameterIterator EncodedFunctionCallView::ParameterIterator::operator++(int)
+{
+    ParameterIterator result = *this;
+    ++*this;
+
+    return result;
+}
+
+void EncodedFunctionCallView::ParameterIterator::read()
+{
+    if (remaining == 0)
+    {
+        return;
+    }
+
+    // Data is validated by EncodedFunctionCallView::read, so this never fails.
+    Reader reader(begin, position, end);
+    reader.readParameter(parameter);
+    position = reader.getPosition();
+}
+
+ParseResult<EncodedFunctionCallView> EncodedFunctionCallView::read(boost::string_view data)
+{
+    Reader reader(data.data(), data.data(), data.data() + data.size());
+    const auto makeError = [&data, &reader]()
+    {
+        return ParseError{PARSE_ERROR_INVALID_ENCODING, static_cast<size_t>(reader.getPosition() - data.data())};
+    };
+
+    if (reader.readByte() != EncodingVersion)
+    {
+        return makeError();
+    }
+
+    EncodedFunctionCallView result;
+    result.name = reader.readName();
+    const uint64_t parameterCount = reader.readVarint();
+    // Each parameter takes at least two bytes, don't trust larger counts.
+    if (reader.isFailed() || parameterCount > data.size())
+    {
+        return makeError();
+    }
+    result.parameterCount = static_cast<size_t>(parameterCount);
+    result.dataBegin = data.data();
+    result.parameters = reader.getPosition();
+    result.dataEnd = data.data() + data.size();
+
+    EncodedParameter parameter;
+    for (size_t i = 0; i < result.parameterCount; ++i)
+    {
+        reader.readParameter(parameter);
+        if (reader.isFailed())
+        {
+            return makeError();
+        }
+    }
+
+    if (reader.getPosition() != result.dataEnd)
+    {
+        return makeError();
+    }
+
+    return result;
+}
+
+EncodedFunctionCallView::EncodedFunctionCallView()
+    : name{InvalidSymbolId, boost::string_view(), 0},
+      parameterCount(0),
+      dataBegin(nullptr),
+      parameters(nullptr),
+      dataEnd(nullptr)
+{}
+
+EncodedFunctionCallView::ParameterIterator EncodedFunctionCallView::begin() const
+{
+    return ParameterIterator(dataBegin, parameters, dataEnd, parameterCount);
+}
+
+EncodedFunctionCallView::ParameterIterator EncodedFunctionCallView::end() const
+{
+    return ParameterIterator();
+}
+
+ParseResult<FunctionCall> decodeFunctionCall(const EncodedFunctionCallView& view, const SymbolTable* symbols)
+{
+    FunctionCall result{};
+    if (!decodeName(view.getName(), symbols, result.name, result.nameId))
+    {
+        return ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, view.getName().offset};
+    }
+    result.parameters.reserve(view.getParameterCount());
+
+    for (const EncodedParameter& param : view)
+    {
+        FunctionCallParameter decoded{};
+        if (param.hasName)
+        {
+            decoded.name.emplace();
+            if (!decodeName(param.name, symbols, *decoded.name, decoded.nameId))
+            {
+                return ParseError{PARSE_ERROR_UNKNOWN_PARAMETER, param.name.offset};
+            }
+        }
+
+        switch (param.valueType)
+        {
+            case ENCODED_VALUE_INTEGER:
+                decoded.value = std::to_string(param.integer);
+                decoded.valueType = CALL_VALUE_NUMBER;
+                break;
+            case ENCODED_VALUE_NUMBER:
+                decoded.value = param.text.to_string();
+                decoded.valueType = CALL_VALUE_NUMBER;
+                break;
+            case ENCODED_VALUE_STRING:
+                decoded.valueType = CALL_VALUE_STRING;
+                decoded.value.reserve(param.text.size() + 2);
+                decoded.value.push_back('"');
+                decoded.value.append(param.text.data(), param.text.size());
+                decoded.value.push_back('"');
+                break;
+            case ENCODED_VALUE_EXPRESSION:
+                decoded.value = param.text.to_string();
+                decoded.valueType = CALL_VALUE_EXPRESSION;
+                break;
+        }
+        result.parameters.push_back(std::move(decoded));
+    }
+
+    return result;
+}
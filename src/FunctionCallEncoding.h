@@ -0,0 +1,154 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_ENCODING_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_ENCODING_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "ParseError.h"
+#include "StringView.h"
+#include "SymbolTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+/// Compact binary encoding of FunctionCall, for passing calls between processes
+/// without printing and re-parsing them:
+///
+///     call      := version:u8 name parameterCount:varint parameter*
+///     parameter := header:u8 [name] value
+///     name      := varint (id << 1 | 1) | varint (size << 1) bytes
+///     value     := varint                 for ENCODED_VALUE_INTEGER
+///                | varint(size) bytes     otherwise, string literal without quotes
+///
+/// where header is EncodedValueType | ParameterHasName flag. Value type comes from
+/// FunctionCallParameter::valueType, never from the text. Names are encoded as ids
+/// only with ENCODE_NAME_IDS, which is only meaningful if both sides share the
+/// SymbolTable (e.g. registered the same functions in the same order).
+
+enum EncodedValueType : int
+{
+    ENCODED_VALUE_INTEGER, // number literal that is a non-negative integer without leading zeroes, fits uint64_t
+    ENCODED_VALUE_NUMBER, // any other number literal, as is
+    ENCODED_VALUE_STRING, // string literal without quotes, escapes are kept
+    ENCODED_VALUE_EXPRESSION, // source text of CALL_VALUE_EXPRESSION, as is
+};
+
+enum FunctionCallEncodingNames : int
+{
+    ENCODE_NAMES, // names only, safe to pass between any processes
+    ENCODE_NAME_IDS, // ids if set, names otherwise, for peers that have the same SymbolTable
+};
+
+/// Appends encoded call to the output. Values must match their valueType, as parsed ones do.
+void encodeFunctionCall(const FunctionCall& call, std::string& output,
+        FunctionCallEncodingNames names = ENCODE_NAMES);
+std::string encodeFunctionCall(const FunctionCall& call, FunctionCallEncodingNames names = ENCODE_NAMES);
+
+/// Either id or name is set.
+struct EncodedName
+{
+    SymbolId id;
+    boost::string_view name;
+    size_t offset; // byte offset of the name in the encoded data
+};
+
+struct EncodedParameter
+{
+    bool hasName;
+    EncodedName name; // valid only if hasName
+    EncodedValueType valueType;
+    uint64_t integer; // valid only for ENCODED_VALUE_INTEGER
+    boost::string_view text; // valid unless ENCODED_VALUE_INTEGER, strings are without quotes
+};
+
+/// Zero-copy reader of encoded call, never allocates.
+/// Views point into encoded data, which must outlive the reader.
+class EncodedFunctionCallView
+{
+public:
+    class ParameterIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef const EncodedParameter value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const EncodedParameter* pointer;
+        typedef const EncodedParameter& reference;
+
+        ParameterIterator();
+
+        const EncodedParameter& operator*() const
+        {
+            return parameter;
+        }
+
+        const EncodedParameter* operator->() const
+        {
+            return &parameter;
+        }
+
+        ParameterIterator& operator++();
+        ParameterIterator operator++(int);
+
+        bool operator==(const ParameterIterator& other) const
+        {
+            return remaining == other.remaining;
+        }
+
+        bool operator!=(const ParameterIterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class EncodedFunctionCallView;
+        ParameterIterator(const char* begin, const char* position, const char* end, size_t remaining);
+        void read();
+
+    private:
+        const char* begin;
+        const char* position;
+        const char* end;
+        size_t remaining;
+        EncodedParameter parameter;
+    };
+
+    /// Validates the data, ParseError::offset is byte offset in the data.
+    static ParseResult<EncodedFunctionCallView> read(boost::string_view data);
+
+    EncodedFunctionCallView();
+
+    const EncodedName& getName() const
+    {
+        return name;
+    }
+
+    size_t getParameterCount() const
+    {
+        return parameterCount;
+    }
+
+    ParameterIterator begin() const;
+    ParameterIterator end() const;
+
+private:
+    EncodedName name;
+    size_t parameterCount;
+    const char* dataBegin;
+    const char* parameters;
+    const char* dataEnd;
+};
+
+/// Converts encoded call back to FunctionCall, which is equal to the encoded one.
+/// Names encoded as ids are resolved with symbols, ids that symbols doesn't have, or any ids
+/// if symbols is nullptr, are reported as PARSE_ERROR_UNKNOWN_FUNCTION or PARSE_ERROR_UNKNOWN_PARAMETER
+/// at the offset of the name. Table that has the ids but assigned in a different order can't be detected.
+ParseResult<FunctionCall> decodeFunctionCall(const EncodedFunctionCallView& view,
+        const SymbolTable* symbols = nullptr);
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_ENCODING_H_INCLUDED
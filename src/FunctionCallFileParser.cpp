@@ -0,0 +1,140 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallFileParser.h"
+
+#include "MappedFile.h"
+#include "ParserContext.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <future>
+
+namespace
+{
+
+// Smaller chunks make task overhead noticeable.
+const size_t MinAutoChunkSize = 64 * 1024;
+// More chunks than threads, to keep threads busy when lines are of uneven length.
+const size_t ChunksPerThread = 4;
+
+struct ChunkResult
+{
+    std::vector<ParsedFunctionCallLine> lines;
+    // Including empty lines.
+    size_t lineCount;
+};
+
+std::vector<boost::string_view> splitIntoChunks(boost::string_view data, size_t chunkSize)
+{
+    std::vector<boost::string_view> chunks;
+    chunks.reserve(data.size() / chunkSize + 1);
+
+    while (!data.empty())
+    {
+        size_t chunkEnd = data.size();
+        if (chunkSize < data.size())
+        {
+            // Extend chunk up to the end of the line.
+            const size_t newline = data.find('\n', chunkSize - 1);
+            if (newline != boost::string_view::npos)
+            {
+                chunkEnd = newline + 1;
+            }
+        }
+
+        chunks.push_back(data.substr(0, chunkEnd));
+        data.remove_prefix(chunkEnd);
+    }
+
+    return chunks;
+}
+
+void parseChunk(boost::string_view chunk, ChunkResult& result)
+{
+    ParserContext context;
+    result.lineCount = 0;
+    while (!chunk.empty())
+    {
+        const size_t newline = chunk.find('\n');
+        boost::string_view line = chunk.substr(0, newline);
+        chunk.remove_prefix(newline == boost::string_view::npos ? chunk.size() : newline + 1);
+        ++result.lineCount;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+
+        context.reset(line);
+        result.lines.push_back(ParsedFunctionCallLine{line, result.lineCount, context.parseCall()});
+    }
+}
+
+} // namespace
+
+std::vector<ParsedFunctionCallLine> parseFunctionCallLines(boost::string_view data,
+        ThreadPool& pool, size_t chunkSize)
+{
+    if (chunkSize == 0)
+    {
+        chunkSize = std::max(MinAutoChunkSize,
+                data.size() / (pool.getThreadCount() * ChunksPerThread) + 1);
+    }
+
+    const std::vector<boost::string_view> chunks = splitIntoChunks(data, chunkSize);
+    std::vector<ChunkResult> chunkResults(chunks.size());
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(chunks.size());
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        const boost::string_view chunk = chunks[i];
+        ChunkResult* chunkResult = &chunkResults[i];
+        tasks.push_back(pool.submit([chunk, chunkResult]()
+        {
+            parseChunk(chunk, *chunkResult);
+        }));
+    }
+
+    // Tasks reference chunkResults, so all must complete before any exception is rethrown.
+    for (auto& task : tasks)
+    {
+        task.wait();
+    }
+
+    size_t totalCalls = 0;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].get();
+        totalCalls += chunkResults[i].lines.size();
+    }
+
+    std::vector<ParsedFunctionCallLine> result;
+    result.reserve(totalCalls);
+
+    size_t linesBefore = 0;
+    for (auto& chunkResult : chunkResults)
+    {
+        for (auto& line : chunkResult.lines)
+        {
+            line.lineNumber += linesBefore;
+            result.push_back(std::move(line));
+        }
+        linesBefore += chunkResult.lineCount;
+    }
+
+    return result;
+}
+
+std::vector<ParsedFunctionCallLine> parseFunctionCallFile(const MappedFile& file,
+        ThreadPool& pool, size_t chunkSize)
+{
+    return parseFunctionCallLines(file.getData(), pool, chunkSize);
+}
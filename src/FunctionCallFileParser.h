@@ -0,0 +1,36 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_FILE_PARSER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_FILE_PARSER_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <vector>
+
+class MappedFile;
+class ThreadPool;
+
+struct ParsedFunctionCallLine
+{
+    boost::string_view line; // points into the parsed data, without line terminator.
+    size_t lineNumber; // 1-based
+    ParseResult<FunctionCall> call;
+};
+
+/// Parses newline-delimited function calls, one call per line, on the pool.
+/// data is split into chunks at newline boundaries, each chunk is parsed by a separate task.
+/// Results are in input order, empty lines are skipped.
+/// chunkSize is approximate chunk size in bytes, 0 means picking one based on pool size.
+std::vector<ParsedFunctionCallLine> parseFunctionCallLines(boost::string_view data,
+        ThreadPool& pool, size_t chunkSize = 0);
+
+/// Same as above, ParsedFunctionCallLine::line is valid for the lifetime of the file.
+std::vector<ParsedFunctionCallLine> parseFunctionCallFile(const MappedFile& file,
+        ThreadPool& pool, size_t chunkSize = 0);
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_FILE_PARSER_H_INCLUDED
@@ -0,0 +1,159 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallStreamParser.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <istream>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+namespace
+{
+
+void processLine(boost::string_view line, size_t lineNumber,
+        const FunctionCallStreamParser::Callback& callback, ParserContext& context, FunctionCall& call)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+
+    if (line.empty())
+    {
+        return;
+    }
+
+    context.reset(line);
+    const ParseError error = context.parseCall(call);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        callback(error, line, lineNumber);
+        return;
+    }
+
+    ParseResult<FunctionCall> result(std::move(call));
+    callback(result, line, lineNumber);
+    // Memory of the call is reused by the next line.
+    call = std::move(result.getValue());
+}
+
+} // namespace
+
+const size_t FunctionCallStreamParser::DefaultChunkSize;
+
+FunctionCallStreamParser::FunctionCallStreamParser(size_t chunkSize, const ParseLimits& limits)
+    : chunkSize(std::max<size_t>(chunkSize, 1)),
+      maxLineLength(limits.maxInputLength),
+      context(nullptr, limits)
+{}
+
+FunctionCallStreamParser::~FunctionCallStreamParser()
+{}
+
+size_t FunctionCallStreamParser::parse(std::istream& input, const Callback& callback)
+{
+    return parseImpl([&input](char* data, size_t size) -> size_t
+    {
+        input.read(data, size);
+        if (input.bad())
+        {
+            throw std::system_error(std::make_error_code(std::errc::io_error),
+                    "Failed to read from stream");
+        }
+
+        return static_cast<size_t>(input.gcount());
+    },
+    callback);
+}
+
+size_t FunctionCallStreamParser::parse(int fileDescriptor, const Callback& callback)
+{
+    return parseImpl([fileDescriptor](char* data, size_t size) -> size_t
+    {
+        while (true)
+        {
+            const ssize_t result = ::read(fileDescriptor, data, size);
+            if (result >= 0)
+            {
+                return static_cast<size_t>(result);
+            }
+            if (errno != EINTR)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                        "Failed to read from file descriptor");
+            }
+        }
+    },
+    callback);
+}
+
+size_t FunctionCallStreamParser::parseImpl(const Reader& reader, const Callback& callback)
+{
+    if (buffer.size() < chunkSize)
+    {
+        buffer.resize(chunkSize);
+    }
+
+    size_t lineNumber = 0;
+    // Bytes at the beginning of the buffer, that belong to the incomplete line.
+    size_t pendingSize = 0;
+    // Rest of the too long line, that is already reported, is dropped up to the newline.
+    bool skippingLine = false;
+    while (true)
+    {
+        if (pendingSize == buffer.size())
+        {
+            // Line doesn't fit into the buffer.
+            buffer.resize(buffer.size() * 2);
+        }
+
+        const size_t bytesRead = reader(buffer.data() + pendingSize, buffer.size() - pendingSize);
+        if (bytesRead == 0)
+        {
+            break;
+        }
+
+        const char* lineBegin = buffer.data();
+        const char* const dataEnd = buffer.data() + pendingSize + bytesRead;
+        // pending data is known to have no newlines.
+        const char* p = buffer.data() + pendingSize;
+        while (const char* newline = static_cast<const char*>(std::memchr(p, '\n', dataEnd - p)))
+        {
+            if (skippingLine)
+            {
+                skippingLine = false;
+            }
+            else
+            {
+                processLine(boost::string_view(lineBegin, newline - lineBegin), ++lineNumber, callback, context, call);
+            }
+            lineBegin = newline + 1;
+            p = lineBegin;
+        }
+
+        pendingSize = skippingLine ? 0 : dataEnd - lineBegin;
+        if (pendingSize > maxLineLength)
+        {
+            callback(ParseError{PARSE_ERROR_INPUT_TOO_LONG, maxLineLength},
+                    boost::string_view(lineBegin, pendingSize), ++lineNumber);
+            skippingLine = true;
+            pendingSize = 0;
+        }
+        std::memmove(buffer.data(), lineBegin, pendingSize);
+    }
+
+    if (pendingSize != 0)
+    {
+        // Last line without trailing newline.
+        processLine(boost::string_view(buffer.data(), pendingSize), ++lineNumber, callback, context, call);
+    }
+
+    return lineNumber;
+}
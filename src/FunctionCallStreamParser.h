@@ -0,0 +1,54 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_STREAM_PARSER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_STREAM_PARSER_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "ParserContext.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+/// Parses newline-delimited function calls, one call per line, reading input
+/// in chunks. Lines may straddle chunk boundaries, empty lines are skipped.
+/// Buffers, parser context and the parsed call are kept between lines and parse() calls,
+/// so reusing the parser avoids re-allocating them. Lines longer than limits.maxInputLength
+/// are reported as PARSE_ERROR_INPUT_TOO_LONG without buffering them whole, line passed to
+/// the callback is the beginning of such line.
+class FunctionCallStreamParser
+{
+public:
+    static const size_t DefaultChunkSize = 1024 * 1024;
+
+    /// line is valid only for the duration of the callback, lineNumber is 1-based.
+    typedef std::function<void (const ParseResult<FunctionCall>& result,
+            boost::string_view line, size_t lineNumber)> Callback;
+
+    explicit FunctionCallStreamParser(size_t chunkSize = DefaultChunkSize,
+            const ParseLimits& limits = DefaultParseLimits);
+    ~FunctionCallStreamParser();
+
+    /// Both return number of lines read, throw std::system_error on read failure.
+    size_t parse(std::istream& input, const Callback& callback);
+    size_t parse(int fileDescriptor, const Callback& callback);
+
+private:
+    typedef std::function<size_t (char* buffer, size_t size)> Reader;
+
+    size_t parseImpl(const Reader& reader, const Callback& callback);
+
+private:
+    const size_t chunkSize;
+    const size_t maxLineLength;
+    std::vector<char> buffer;
+    ParserContext context;
+    FunctionCall call;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_STREAM_PARSER_H_INCLUDED
@@ -0,0 +1,40 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_VISITOR_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_VISITOR_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "Lexer.h"
+#include "ParseError.h"
+#include "StringView.h"
+
+/// Receives parts of the function call as they are parsed, lets consumers
+/// build their own representation of the call without FunctionCall.
+class FunctionCallVisitor
+{
+public:
+    virtual ~FunctionCallVisitor()
+    {}
+
+    /// Returning anything but PARSE_ERROR_NONE stops parsing with that error.
+    virtual ParseErrorCode visitFunctionName(const Lexeme& name) = 0;
+    /// name is nullptr for positional parameters, value is number or string literal,
+    /// or LEX_EXPRESSION with source text of the expression, like "g(1) + 2",
+    /// or LEX_PLACEHOLDER for templates.
+    virtual ParseErrorCode visitParameter(const Lexeme* name, const Lexeme& value) = 0;
+};
+
+/// Kind of the value given to visitParameter, CALL_VALUE_EXPRESSION for placeholders too.
+CallValueType getCallValueType(const Lexeme& value);
+
+/// Same grammar as tryParseFunctionCall, error offset of the visitor error
+/// points at the name of the function or parameter.
+ParseError visitFunctionCall(boost::string_view input, FunctionCallVisitor& visitor);
+/// Also allows '?' as a whole argument, passed to the visitor as LEX_PLACEHOLDER,
+/// e.g. `f(a=?, b=?, c="fixed")`.
+ParseError visitFunctionCallTemplate(boost::string_view input, FunctionCallVisitor& visitor);
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_CALL_VISITOR_H_INCLUDED
@@ -0,0 +1,207 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_DISPATCHER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_DISPATCHER_H_INCLUDED
+
+#include "CallBinder.h"
+#include "FunctionParser.h"
+#include "Lexer.h"
+#include "ParseError.h"
+#include "ResultCache.h"
+#include "SymbolTable.h"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum FunctionPurity : int
+{
+    FUNCTION_IMPURE,
+    FUNCTION_PURE, // same arguments always give same result, no side effects.
+};
+
+/// Invokes C++ callables registered with function specs by text calls.
+/// Function is looked up by interned name in a table indexed by SymbolId,
+/// arguments are converted to callable's parameter types by CallBinder.
+///
+///     FunctionDispatcher<double> dispatcher;
+///     dispatcher.addFunction<double (double, double)>("pow(x, y=2)",
+///             [](double x, double y) { return std::pow(x, y); }, FUNCTION_PURE);
+///     ParseResult<double> result = dispatcher.dispatch("pow(3)");
+///
+/// Results of FUNCTION_PURE functions are cached by converted arguments with defaults
+/// applied, so "pow(3)" and "pow(y=2, x=3.0)" share an entry.
+/// Exceptions thrown by callables are propagated to the caller of dispatch().
+/// Concurrent dispatch() calls are safe as long as nobody calls addFunction().
+template <typename Result>
+class FunctionDispatcher
+{
+    static_assert(!std::is_void<Result>::value, "Result must be a value type.");
+
+public:
+    static const size_t DefaultResultCacheSize = 1024;
+
+    /// resultCacheSize is max number of cached results per pure function.
+    explicit FunctionDispatcher(size_t resultCacheSize = DefaultResultCacheSize)
+        : resultCacheSize(resultCacheSize)
+    {}
+
+    /// Replaces function with the same name, if any. Signature is Result(Args...),
+    /// callable is invoked with arguments in spec parameter order.
+    /// Throws ParseException on malformed spec and std::invalid_argument
+    /// if spec doesn't match the signature, see CallBinder.
+    template <typename Signature, typename Callable>
+    std::string addFunction(const std::string& functionSpecification, Callable callable,
+            FunctionPurity purity = FUNCTION_IMPURE)
+    {
+        return addFunction<Signature>(parseFunctionSpec(functionSpecification), std::move(callable), purity);
+    }
+
+    template <typename Signature, typename Callable>
+    std::string addFunction(const FunctionSpec& spec, Callable callable, FunctionPurity purity = FUNCTION_IMPURE)
+    {
+        std::unique_ptr<ResultCache<Result>> resultCache(
+                (purity == FUNCTION_PURE) ? new ResultCache<Result>(resultCacheSize) : nullptr);
+        std::unique_ptr<Entry> entry(new BoundEntry<Signature, Callable>(spec, std::move(callable),
+                std::move(resultCache)));
+
+        const SymbolId nameId = symbols.intern(spec.name);
+        if (entries.size() <= nameId)
+        {
+            entries.resize(nameId + 1);
+        }
+        entries[nameId] = std::move(entry);
+
+        return spec.name;
+    }
+
+    /// On success result is assigned return value of the callable.
+    ParseError dispatch(boost::string_view input, Result& result) const
+    {
+        Lexer lexer(input);
+        const Lexeme name = lexer.getNextLexeme();
+        if (name.type != LEX_NAME)
+        {
+            return ParseError{name.type == LEX_ERROR ? lexer.getError() : PARSE_ERROR_EXPECTED_FUNCTION_NAME,
+                    name.offset};
+        }
+
+        const SymbolId nameId = symbols.find(name.value);
+        if (nameId >= entries.size() || !entries[nameId])
+        {
+            return ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, name.offset};
+        }
+
+        return entries[nameId]->dispatch(input, result);
+    }
+
+    ParseResult<Result> dispatch(boost::string_view input) const
+    {
+        Result result{};
+        const ParseError error = dispatch(input, result);
+        if (error.code != PARSE_ERROR_NONE)
+        {
+            return error;
+        }
+
+        return result;
+    }
+
+    /// Hits and misses of the result cache, all zeroes for impure functions.
+    /// Throws std::out_of_range if there is no such function.
+    ResultCacheStatistics getResultCacheStatistics(boost::string_view functionName) const
+    {
+        const SymbolId nameId = symbols.find(functionName);
+        if (nameId >= entries.size() || !entries[nameId])
+        {
+            throw std::out_of_range("Unknown function: \"" + functionName.to_string() + "\"");
+        }
+
+        return entries[nameId]->getResultCacheStatistics();
+    }
+
+private:
+    struct Entry
+    {
+        virtual ~Entry() = default;
+        virtual ParseError dispatch(boost::string_view input, Result& result) const = 0;
+        virtual ResultCacheStatistics getResultCacheStatistics() const = 0;
+    };
+
+    template <typename Signature, typename Callable>
+    class BoundEntry : public Entry
+    {
+    public:
+        /// resultCache is nullptr for impure functions.
+        BoundEntry(const FunctionSpec& spec, Callable callable, std::unique_ptr<ResultCache<Result>> resultCache)
+            : binder(spec),
+              callable(std::move(callable)),
+              resultCache(std::move(resultCache))
+        {}
+
+        ParseError dispatch(boost::string_view input, Result& result) const override
+        {
+            typename CallBinder<Signature>::Arguments arguments;
+            const ParseError error = binder.bind(input, arguments);
+            if (error.code != PARSE_ERROR_NONE)
+            {
+                return error;
+            }
+
+            if (!resultCache)
+            {
+                result = invoke(arguments, std::make_index_sequence<std::tuple_size<decltype(arguments)>::value>());
+                return error;
+            }
+
+            // Reused by all calls on this thread, to avoid allocating a key per call.
+            static thread_local std::string key;
+            makeResultCacheKey(key, arguments);
+            if (!resultCache->find(key, result))
+            {
+                // Callable may dispatch other calls on this thread, overwriting the key.
+                const std::string missedKey = key;
+                result = invoke(arguments, std::make_index_sequence<std::tuple_size<decltype(arguments)>::value>());
+                resultCache->insert(missedKey, result);
+            }
+
+            return error;
+        }
+
+        ResultCacheStatistics getResultCacheStatistics() const override
+        {
+            return resultCache ? resultCache->getStatistics() : ResultCacheStatistics{0, 0, 0};
+        }
+
+    private:
+        template <typename Arguments, size_t... I>
+        Result invoke(Arguments& arguments, std::index_sequence<I...>) const
+        {
+            return callable(std::move(std::get<I>(arguments))...);
+        }
+
+    private:
+        CallBinder<Signature> binder;
+        Callable callable;
+        std::unique_ptr<ResultCache<Result>> resultCache;
+    };
+
+private:
+    const size_t resultCacheSize;
+    SymbolTable symbols;
+    // Indexed by SymbolId of the function name, nullptr for unknown names.
+    std::vector<std::unique_ptr<Entry>> entries;
+};
+
+template <typename Result>
+const size_t FunctionDispatcher<Result>::DefaultResultCacheSize;
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_DISPATCHER_H_INCLUDED
@@ -4,126 +4,459 @@
 */
 
 #include "FunctionParser.h"
+#include "ExpressionParser.h"
+#include "FunctionCallVisitor.h"
+#include "Instrumentation.h"
 #include "Lexer.h"
-
-#include <algorithm>
-#include <cassert>
+#include "ParserContext.h"
+#include "Tracing.h"
 
 namespace
 {
 
-void validateFunctionSpec(const FunctionSpec& /*spec*/)
+bool isValueLexeme(const Lexeme& lex)
+{
+    return lex.type == LEX_NUMBER_LITERAL || lex.type == LEX_STRING_LITERAL;
+}
+
+bool isComma(const Lexeme& lex)
+{
+    return lex.type == LEX_PUNCTUATION && lex.value == ",";
+}
+
+bool isPlaceholder(const Lexeme& lex)
+{
+    return lex.type == LEX_PUNCTUATION && lex.value == "?";
+}
+
+bool isEndOfArgument(const Lexeme& lex)
+{
+    return isComma(lex) || lex.type == LEX_RIGHT_PARENTHESIS;
+}
+
+bool isAssignment(const Lexeme& lex)
 {
+    return lex.type == LEX_OPERATOR && lex.value == "=";
 }
 
-void validateFunctionCall(const FunctionCall& call)
+/// Error from the Lexer takes precedence over the one detected by the parser.
+ParseError makeError(const Lexer& lexer, const Lexeme& lex, ParseErrorCode code)
 {
-    const auto isNamedParameter = [](const FunctionCallParameter& param)
+    if (lex.type == LEX_ERROR)
     {
-        return param.name.is_initialized();
-    };
+        return ParseError{lexer.getError(), lex.offset};
+    }
 
-    const auto firstNamed = std::find_if(call.parameters.begin(), call.parameters.end(),
-            isNamedParameter);
-    const auto unnamed = std::find_if_not(firstNamed, call.parameters.end(), isNamedParameter);
+    return ParseError{code, lex.offset};
+}
 
-    assert(unnamed == call.parameters.end());
+SymbolId findSymbol(const SymbolTable* symbols, boost::string_view name)
+{
+    return symbols ? symbols->find(name) : InvalidSymbolId;
 }
 
-} // namespace
+void assign(std::string& target, boost::string_view value)
+{
+    target.assign(value.data(), value.size());
+}
 
+void assign(boost::optional<std::string>& target, boost::string_view value)
+{
+    if (target)
+    {
+        assign(*target, value);
+    }
+    else
+    {
+        target.emplace(value.data(), value.size());
+    }
+}
 
-FunctionSpec parseFunctionSpec(const std::string& input)
+/// Builds the call in place, reusing parameters and strings that result already has,
+/// so parsing into the same call over and over doesn't allocate. Parameters dropped from
+/// the result are kept in spare, if given, so that their strings are reused by later calls.
+class FunctionCallBuilder : public FunctionCallVisitor
 {
-    FunctionSpec result;
-    Lexer lexer(input);
+public:
+    FunctionCallBuilder(const SymbolTable* symbols, FunctionCall& result, FunctionCallParameters* spare = nullptr)
+        : result(result),
+          symbols(symbols),
+          spare(spare),
+          parameterCount(0)
+    {}
 
-    Lexeme lex = lexer.getNextLexeme();
-    assert(lex.type == LEX_NAME);
-    result.name = lex.value;
+    ParseErrorCode visitFunctionName(const Lexeme& name) override
+    {
+        assign(result.name, name.value);
+        result.nameId = findSymbol(symbols, name.value);
 
-    assert(lexer.getNextLexeme().type == LEX_LEFT_PARENTHESIS);
-    // parsing arguments
-    while (true)
+        return PARSE_ERROR_NONE;
+    }
+
+    ParseErrorCode visitParameter(const Lexeme* name, const Lexeme& value) override
     {
-        lex = lexer.getNextLexeme();
-        if (lex.type == LEX_RIGHT_PARENTHESIS && lex.value == ")")
+        if (parameterCount == result.parameters.size())
+        {
+            if (spare && !spare->empty())
+            {
+                result.parameters.push_back(std::move(spare->back()));
+                spare->pop_back();
+            }
+            else
+            {
+                result.parameters.push_back(FunctionCallParameter{boost::none, std::string(), CALL_VALUE_NUMBER,
+                        InvalidSymbolId});
+            }
+        }
+        FunctionCallParameter& param = result.parameters[parameterCount++];
+        if (name)
         {
-            // do not expect nested parenthesis here.
-            break;
+            assign(param.name, name->value);
+            param.nameId = findSymbol(symbols, name->value);
         }
-        if (lex.type == LEX_PUNCTUATION && lex.value == ",")
+        else
         {
-            assert(!result.parameters.empty() && "Stray comma");
+            param.name = boost::none;
+            param.nameId = InvalidSymbolId;
+        }
+        assign(param.value, value.value);
+        param.valueType = getCallValueType(value);
 
-            // skip to the next argument.
-            continue;
+        return PARSE_ERROR_NONE;
+    }
+
+    /// Drops parameters left from the previous call.
+    void finish()
+    {
+        while (result.parameters.size() > parameterCount)
+        {
+            if (spare)
+            {
+                spare->push_back(std::move(result.parameters.back()));
+            }
+            result.parameters.pop_back();
         }
+    }
 
-        result.parameters.push_back(FunctionSpecParameter{});
-        FunctionSpecParameter& param = result.parameters.back();
+private:
+    FunctionCall& result;
+    const SymbolTable* symbols;
+    FunctionCallParameters* spare;
+    size_t parameterCount;
+};
 
-        assert(lex.type == LEX_NAME);
-        param.name = lex.value;
+template <typename T>
+T valueOrThrow(ParseResult<T> result)
+{
+    if (!result)
+    {
+        throw ParseException(result.getError());
+    }
+
+    return std::move(result.getValue());
+}
+
+/// Same as FunctionCallBuilder, reuses memory of the result.
+ParseError buildFunctionSpec(boost::string_view input, const SymbolTable* symbols, const ParseLimits& limits,
+        FunctionSpec& result)
+{
+    const ParseError NoError{PARSE_ERROR_NONE, 0};
+    size_t parameterCount = 0;
+    Lexer lexer(input, limits);
+
+    Lexeme lex = lexer.getNextLexeme();
+    if (lex.type != LEX_NAME)
+    {
+        return makeError(lexer, lex, PARSE_ERROR_EXPECTED_FUNCTION_NAME);
+    }
+    assign(result.name, lex.value);
+    result.nameId = findSymbol(symbols, lex.value);
+
+    lex = lexer.getNextLexeme();
+    if (lex.type != LEX_LEFT_PARENTHESIS)
+    {
+        return makeError(lexer, lex, PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS);
+    }
+
+    // parsing arguments
+    lex = lexer.getNextLexeme();
+    while (lex.type != LEX_RIGHT_PARENTHESIS)
+    {
+        if (lex.type != LEX_NAME)
+        {
+            return makeError(lexer, lex, PARSE_ERROR_EXPECTED_PARAMETER_NAME);
+        }
+
+        if (parameterCount == result.parameters.size())
+        {
+            result.parameters.push_back(FunctionSpecParameter{std::string(), boost::none, InvalidSymbolId});
+        }
+        FunctionSpecParameter& param = result.parameters[parameterCount++];
+        assign(param.name, lex.value);
+        param.nameId = findSymbol(symbols, lex.value);
 
         lex = lexer.getNextLexeme();
-        if (lex.type == LEX_OPERATOR && lex.value == "=")
+        if (isAssignment(lex))
         {
             // next is default value
+            lex = lexer.getNextLexeme();
+            if (!isValueLexeme(lex))
+            {
+                return makeError(lexer, lex, PARSE_ERROR_EXPECTED_VALUE);
+            }
+            assign(param.value, lex.value);
+
+            lex = lexer.getNextLexeme();
+        }
+        else
+        {
+            param.value = boost::none;
+        }
 
+        if (isComma(lex))
+        {
+            // skip to the next argument, which must be present.
             lex = lexer.getNextLexeme();
-            assert(lex.type == LEX_NUMBER_LITERAL || lex.type == LEX_STRING_LITERAL);
-            param.value = lex.value;
+            if (lex.type == LEX_RIGHT_PARENTHESIS)
+            {
+                return makeError(lexer, lex, PARSE_ERROR_EXPECTED_PARAMETER_NAME);
+            }
+        }
+        else if (lex.type != LEX_RIGHT_PARENTHESIS)
+        {
+            return makeError(lexer, lex, PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS);
         }
     }
 
-    validateFunctionSpec(result);
+    lex = lexer.getNextLexeme();
+    if (lex.type != LEX_END_OF_INPUT)
+    {
+        return makeError(lexer, lex, PARSE_ERROR_TRAILING_INPUT);
+    }
+    result.parameters.resize(parameterCount, FunctionSpecParameter{std::string(), boost::none, InvalidSymbolId});
 
-    return result;
+    return NoError;
 }
 
-FunctionCall parseFunctionCall(const std::string& input)
+/// functionName is set once it is parsed.
+ParseError visitFunctionCallImpl(boost::string_view input, FunctionCallVisitor& visitor, bool allowPlaceholders,
+        const ParseLimits& limits, ExpressionTree& expressionTree, boost::string_view& functionName)
 {
-    FunctionCall result;
-    Lexer lexer(input);
+    const ParseError NoError{PARSE_ERROR_NONE, 0};
+    ExpressionParser parser(input, limits);
 
-    Lexeme lex = lexer.getNextLexeme();
-    assert(lex.type == LEX_NAME);
-    result.name = lex.value;
+    if (parser.getLexeme().type != LEX_NAME)
+    {
+        return parser.makeError(PARSE_ERROR_EXPECTED_FUNCTION_NAME);
+    }
+    functionName = parser.getLexeme().value;
+    ParseErrorCode visitorError = visitor.visitFunctionName(parser.getLexeme());
+    if (visitorError != PARSE_ERROR_NONE)
+    {
+        return ParseError{visitorError, parser.getLexeme().offset};
+    }
+
+    parser.nextLexeme();
+    if (parser.getLexeme().type != LEX_LEFT_PARENTHESIS)
+    {
+        return parser.makeError(PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS);
+    }
 
-    assert(lexer.getNextLexeme().type == LEX_LEFT_PARENTHESIS);
     // parsing arguments
-    while (true)
+    bool hasNamedParameters = false;
+    parser.nextLexeme();
+    while (parser.getLexeme().type != LEX_RIGHT_PARENTHESIS)
     {
-        lex = lexer.getNextLexeme();
-        if (lex.type == LEX_RIGHT_PARENTHESIS && lex.value == ")")
+        Lexeme name;
+        ParseError error = parser.parseArgumentName(name, hasNamedParameters, allowPlaceholders);
+        if (error.code != PARSE_ERROR_NONE)
         {
-            // do not expect nested parenthesis here.
-            break;
+            return error;
         }
-        if (lex.type == LEX_PUNCTUATION && lex.value == ",")
-        {
-            assert(!result.parameters.empty() && "Stray comma");
 
-            // skip to the next argument.
-            continue;
+        Lexeme value = parser.getLexeme();
+        if (isValueLexeme(value) && isEndOfArgument(parser.peekLexeme()))
+        {
+            // Fast path for literals.
+            parser.nextLexeme();
+        }
+        else if (allowPlaceholders && isPlaceholder(value))
+        {
+            value.type = LEX_PLACEHOLDER;
+            parser.nextLexeme();
+        }
+        else
+        {
+            ExpressionNodeIndex root = InvalidExpressionNodeIndex;
+            expressionTree.clear();
+            error = parser.parseExpression(expressionTree, root);
+            if (error.code != PARSE_ERROR_NONE)
+            {
+                return error;
+            }
+            const ExpressionNode& node = expressionTree.getNode(root);
+            if (node.type == EXPRESSION_NUMBER || node.type == EXPRESSION_STRING)
+            {
+                // Folded constant, parenthesized literal, or literal followed by unexpected lexeme
+                // that is reported below.
+                value = Lexeme{node.value, node.type == EXPRESSION_NUMBER ? LEX_NUMBER_LITERAL : LEX_STRING_LITERAL,
+                        node.offset};
+            }
+            else
+            {
+                value = Lexeme{input.substr(value.offset, parser.getPreviousLexemeEnd() - value.offset),
+                        LEX_EXPRESSION, value.offset};
+            }
         }
 
-        result.parameters.push_back(FunctionCallParameter{});
-        FunctionCallParameter& param = result.parameters.back();
+        visitorError = visitor.visitParameter(name.value.empty() ? nullptr : &name, value);
+        if (visitorError != PARSE_ERROR_NONE)
+        {
+            return ParseError{visitorError, name.offset};
+        }
 
-        if (lex.type == LEX_NAME)
+        error = parser.parseArgumentSeparator();
+        if (error.code != PARSE_ERROR_NONE)
         {
-            param.name = lex.value;
-            lex = lexer.getNextLexeme();
-            assert(lex.type == LEX_OPERATOR && lex.value == "=");
-            lex = lexer.getNextLexeme();
+            return error;
         }
-        assert(lex.type == LEX_NUMBER_LITERAL || lex.type == LEX_STRING_LITERAL);
-        param.value = lex.value;
     }
 
-    validateFunctionCall(result);
+    parser.nextLexeme();
+    if (parser.getLexeme().type != LEX_END_OF_INPUT)
+    {
+        return parser.makeError(PARSE_ERROR_TRAILING_INPUT);
+    }
+
+    return NoError;
+}
+
+ParseError visitFunctionCall(boost::string_view input, FunctionCallVisitor& visitor, bool allowPlaceholders,
+        const ParseLimits& limits, ExpressionTree& expressionTree)
+{
+    EQUEUM_INSTRUMENTATION_SCOPE(scope, INSTRUMENTATION_PARSE_FUNCTION_CALL);
+    EQUEUM_INSTRUMENTATION_BYTES(scope, input.size());
+    EQUEUM_TRACE_PROBE2(call__parse__start, input.data(), input.size());
+
+    boost::string_view functionName;
+    const ParseError error = visitFunctionCallImpl(input, visitor, allowPlaceholders, limits, expressionTree,
+            functionName);
+    EQUEUM_TRACE_PROBE6(call__parse__end, input.data(), input.size(), functionName.data(), functionName.size(),
+            static_cast<int>(error.code), error.offset);
+
+    return error;
+}
+
+} // namespace
+
+ParseResult<FunctionSpec> tryParseFunctionSpec(boost::string_view input,
+        const SymbolTable* symbols)
+{
+    FunctionSpec result{};
+    const ParseError error = buildFunctionSpec(input, symbols, DefaultParseLimits, result);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
 
     return result;
 }
+
+ParseError visitFunctionCall(boost::string_view input, FunctionCallVisitor& visitor)
+{
+    // Only used by arguments that are expressions, hence doesn't allocate for literals.
+    ExpressionTree expressionTree;
+    return visitFunctionCall(input, visitor, false, DefaultParseLimits, expressionTree);
+}
+
+ParseError visitFunctionCallTemplate(boost::string_view input, FunctionCallVisitor& visitor)
+{
+    ExpressionTree expressionTree;
+    return visitFunctionCall(input, visitor, true, DefaultParseLimits, expressionTree);
+}
+
+ParseResult<FunctionCall> tryParseFunctionCall(boost::string_view input,
+        const SymbolTable* symbols)
+{
+    FunctionCall result{};
+    FunctionCallBuilder builder(symbols, result);
+    const ParseError error = visitFunctionCall(input, builder);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+    builder.finish();
+
+    return result;
+}
+
+ParserContext::ParserContext(const SymbolTable* symbols, const ParseLimits& limits)
+    : symbols(symbols),
+      limits(limits)
+{}
+
+ParserContext::~ParserContext()
+{}
+
+void ParserContext::reset(boost::string_view newInput)
+{
+    input = newInput;
+}
+
+ParseError ParserContext::parseCall(FunctionCall& result)
+{
+    FunctionCallBuilder builder(symbols, result, &spareParameters);
+    const ParseError error = visitFunctionCall(input, builder, false, limits, expressionTree);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+    builder.finish();
+
+    return error;
+}
+
+ParseResult<FunctionCall> ParserContext::parseCall()
+{
+    FunctionCall result{};
+    const ParseError error = parseCall(result);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+
+    return result;
+}
+
+ParseError ParserContext::parseSpec(FunctionSpec& result)
+{
+    return buildFunctionSpec(input, symbols, limits, result);
+}
+
+FunctionSpec parseFunctionSpec(boost::string_view input, const SymbolTable* symbols)
+{
+    return valueOrThrow(tryParseFunctionSpec(input, symbols));
+}
+
+FunctionCall parseFunctionCall(boost::string_view input, const SymbolTable* symbols)
+{
+    return valueOrThrow(tryParseFunctionCall(input, symbols));
+}
+
+CallValueType getCallValueType(const Lexeme& value)
+{
+    switch (value.type)
+    {
+        case LEX_NUMBER_LITERAL:
+            return CALL_VALUE_NUMBER;
+        case LEX_STRING_LITERAL:
+            return CALL_VALUE_STRING;
+        default:
+            return CALL_VALUE_EXPRESSION;
+    }
+}
+
+CallValueType getLiteralValueType(boost::string_view literal)
+{
+    return (!literal.empty() && literal[0] == '"') ? CALL_VALUE_STRING : CALL_VALUE_NUMBER;
+}
@@ -5,38 +5,89 @@
 #ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_PARSER_H_INCLUDED
 #define EQUEUM_FUNCTION_PARSER_FUNCTION_PARSER_H_INCLUDED
 
+#include "MemoryResource.h"
+#include "ParseError.h"
+#include "ParseLimits.h"
+#include "SmallVector.h"
+#include "StringView.h"
+#include "SymbolTable.h"
+
 #include <boost/optional.hpp>
 
 #include <cstddef>
 #include <exception>
 #include <string>
-#include <vector>
+
+/// Number of parameters of calls and specs stored without allocation, more go to the heap.
+/// Changes the layout of FunctionCall and FunctionSpec, so must be the same for the library
+/// and its users, set it with CMake option FUNCTION_PARSER_INLINE_PARAMETERS.
+#ifndef EQUEUM_FUNCTION_PARSER_INLINE_PARAMETERS
+#define EQUEUM_FUNCTION_PARSER_INLINE_PARAMETERS 6
+#endif
+
+// nameId members are InvalidSymbolId unless name was resolved against a SymbolTable.
+// Call argument values are literals unless valueType is CALL_VALUE_EXPRESSION, consumers
+// that expect literals must check it, expressions can be evaluated with ExpressionProgram.
+// Parameters that don't fit inline are allocated from the MemoryResource given to the
+// parameters' constructor, the default one otherwise. Strings use the global heap.
 
 struct FunctionSpecParameter
 {
     std::string name;
     boost::optional<std::string> value;
+    SymbolId nameId;
 };
 
+typedef SmallVector<FunctionSpecParameter, EQUEUM_FUNCTION_PARSER_INLINE_PARAMETERS,
+        ResourceAllocator<FunctionSpecParameter>> FunctionSpecParameters;
+
 struct FunctionSpec
 {
     std::string name;
-    std::vector<FunctionSpecParameter> parameters;
+    FunctionSpecParameters parameters;
+    SymbolId nameId;
+};
+
+/// Kind of the value text of a call argument.
+enum CallValueType : int
+{
+    CALL_VALUE_NUMBER, // number literal, e.g. -1.5, also the result of folding like 6 for 2 * 3
+    CALL_VALUE_STRING, // string literal as written, with quotes and escapes, e.g. "a\"b"
+    CALL_VALUE_EXPRESSION, // source text of expression that can't be folded, e.g. g(1) + 2 or 1 / 0
 };
 
 struct FunctionCallParameter
 {
     boost::optional<std::string> name;
     std::string value;
+    CallValueType valueType;
+    SymbolId nameId;
 };
 
+typedef SmallVector<FunctionCallParameter, EQUEUM_FUNCTION_PARSER_INLINE_PARAMETERS,
+        ResourceAllocator<FunctionCallParameter>> FunctionCallParameters;
+
 struct FunctionCall
 {
     std::string name;
-    std::vector<FunctionCallParameter> parameters;
+    FunctionCallParameters parameters;
+    SymbolId nameId;
 };
 
-FunctionSpec parseFunctionSpec(const std::string& input);
-FunctionCall parseFunctionCall(const std::string& input);
+/// Report malformed input via ParseResult, never throw.
+/// Input exceeding DefaultParseLimits is an error, use ParserContext for other limits.
+/// If symbols are given, function and parameter names are resolved to ids,
+/// names that are not in the table get InvalidSymbolId.
+ParseResult<FunctionSpec> tryParseFunctionSpec(boost::string_view input,
+        const SymbolTable* symbols = nullptr);
+ParseResult<FunctionCall> tryParseFunctionCall(boost::string_view input,
+        const SymbolTable* symbols = nullptr);
+
+/// Same as above, but throw ParseException on malformed input.
+FunctionSpec parseFunctionSpec(boost::string_view input, const SymbolTable* symbols = nullptr);
+FunctionCall parseFunctionCall(boost::string_view input, const SymbolTable* symbols = nullptr);
+
+/// Type of text known to be a number or string literal, like a default value of a spec parameter.
+CallValueType getLiteralValueType(boost::string_view literal);
 
 #endif // EQUEUM_FUNCTION_PARSER_FUNCTION_PARSER_H_INCLUDED
@@ -4,10 +4,98 @@
 */
 #include "FunctionParser.h"
 #include "FunctionRegistry.h"
+#include "Instrumentation.h"
+#include "Tracing.h"
 
-#include <unordered_set>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 
-FunctionRegistry::FunctionRegistry()
+namespace
+{
+
+/// Set of spec parameter positions, allocates only for specs with more than 64 parameters.
+class ParameterSet
+{
+public:
+    explicit ParameterSet(size_t size)
+        : bits(0),
+          overflow(size > MaxInlineSize ? size : 0)
+    {}
+
+    void insert(size_t position)
+    {
+        if (overflow.empty())
+        {
+            bits |= uint64_t(1) << position;
+        }
+        else
+        {
+            overflow[position] = true;
+        }
+    }
+
+    bool contains(size_t position) const
+    {
+        if (overflow.empty())
+        {
+            return (bits & (uint64_t(1) << position)) != 0;
+        }
+
+        return overflow[position];
+    }
+
+private:
+    static const size_t MaxInlineSize = 64;
+
+    uint64_t bits;
+    std::vector<bool> overflow;
+};
+
+/// Returns position of the spec parameter or spec.parameters.size() if there is none.
+size_t findParameterPosition(const RegisteredFunctionSpec& spec, SymbolId parameterNameId)
+{
+    size_t i = 0;
+    for (; i < spec.parameters.size(); ++i)
+    {
+        if (spec.parameters[i].nameId == parameterNameId)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+boost::optional<std::string> toOptionalString(const boost::optional<boost::string_view>& value)
+{
+    if (!value)
+    {
+        return boost::none;
+    }
+
+    return value->to_string();
+}
+
+} // namespace
+
+FunctionSpec RegisteredFunctionSpec::toFunctionSpec() const
+{
+    FunctionSpec result{name.to_string(), FunctionSpecParameters(), nameId};
+    result.parameters.reserve(parameters.size());
+    for (const auto& parameter : parameters)
+    {
+        result.parameters.push_back(FunctionSpecParameter{parameter.name.to_string(),
+                toOptionalString(parameter.value), parameter.nameId});
+    }
+
+    return result;
+}
+
+FunctionRegistry::FunctionRegistry(MemoryResource* resource)
+    : symbols(resource),
+      values(resource),
+      functionSpecs(ResourceAllocator<RegisteredFunctionSpec>(resource))
 {
 }
 
@@ -16,25 +104,71 @@ FunctionRegistry::~FunctionRegistry()
 
 std::string FunctionRegistry::addFunction(const std::string& functionSpecification)
 {
-    FunctionSpec spec = parseFunctionSpec(functionSpecification);
+    return addFunction(parseFunctionSpec(functionSpecification));
+}
+
+std::string FunctionRegistry::addFunction(const FunctionSpec& spec)
+{
+    const SymbolId nameId = symbols.intern(spec.name);
+
+    // Allocator of parameters is not propagated on assignment, so slots are created with it.
+    while (functionSpecs.size() <= symbols.getSize())
+    {
+        functionSpecs.push_back(RegisteredFunctionSpec{boost::string_view(),
+                RegisteredFunctionSpecParameters(functionSpecs.get_allocator()), InvalidSymbolId});
+    }
 
-    const std::string name = spec.name;
-    functionSpecs.emplace(name, std::move(spec));
+    // Existing function with the same name is kept.
+    RegisteredFunctionSpec& slot = functionSpecs[nameId];
+    const bool added = slot.nameId == InvalidSymbolId;
+    if (added)
+    {
+        slot.parameters.clear();
+        for (const auto& param : spec.parameters)
+        {
+            const SymbolId parameterNameId = symbols.intern(param.name);
+            boost::optional<boost::string_view> value;
+            if (param.value)
+            {
+                value = values.getName(values.intern(*param.value));
+            }
+            slot.parameters.push_back(RegisteredFunctionSpecParameter{symbols.getName(parameterNameId), value,
+                    parameterNameId});
+        }
+        slot.name = symbols.getName(nameId);
+        slot.nameId = nameId;
+    }
+    EQUEUM_TRACE_PROBE3(spec__register, spec.name.c_str(), slot.parameters.size(), static_cast<int>(added));
 
-    return name;
+    return spec.name;
 }
 
 FunctionSpec FunctionRegistry::getFunctionSpecByName(const std::string& functionName) const
 {
-    return functionSpecs.at(functionName);
+    const RegisteredFunctionSpec* spec = findFunctionSpec(symbols.find(functionName));
+    if (!spec)
+    {
+        throw std::out_of_range("Unknown function: " + functionName);
+    }
+
+    return spec->toFunctionSpec();
+}
+
+const RegisteredFunctionSpec* FunctionRegistry::findFunctionSpecByName(boost::string_view functionName) const
+{
+    return findFunctionSpec(symbols.find(functionName));
 }
 
 bool FunctionRegistry::deleteFunctionSpecByName(const std::string& functionName)
 {
-    const auto p = functionSpecs.find(functionName);
-    if (p != functionSpecs.end())
+    const SymbolId nameId = symbols.find(functionName);
+    if (findFunctionSpec(nameId))
     {
-        functionSpecs.erase(p);
+        // Name stays interned, since ids may be held by parsed calls.
+        RegisteredFunctionSpec& slot = functionSpecs[nameId];
+        slot.name = boost::string_view();
+        slot.parameters.clear();
+        slot.nameId = InvalidSymbolId;
 
         return true;
     }
@@ -44,30 +178,59 @@ bool FunctionRegistry::deleteFunctionSpecByName(const std::string& functionName)
 
 FunctionCall FunctionRegistry::updateFunctionCall(const FunctionCall& call) const
 {
+    EQUEUM_INSTRUMENTATION_SCOPE(scope, INSTRUMENTATION_UPDATE_FUNCTION_CALL);
+    const SymbolId callNameId = (call.nameId != InvalidSymbolId)
+            ? call.nameId
+            : symbols.find(call.name);
+    const RegisteredFunctionSpec* spec = findFunctionSpec(callNameId);
+    if (!spec)
+    {
+        EQUEUM_TRACE_PROBE3(call__bind, call.name.c_str(), call.parameters.size(),
+                static_cast<int>(PARSE_ERROR_UNKNOWN_FUNCTION));
+        throw std::out_of_range("Unknown function: " + call.name);
+    }
+    if (call.parameters.size() > spec->parameters.size())
+    {
+        EQUEUM_TRACE_PROBE3(call__bind, call.name.c_str(), call.parameters.size(),
+                static_cast<int>(PARSE_ERROR_TOO_MANY_PARAMETERS));
+        throw std::invalid_argument("Too many parameters for function: " + call.name);
+    }
+
     // Add default values of any missing parameters.
     FunctionCall result(call);
+    result.nameId = callNameId;
 
-    // Collection of named call parameters.
-    std::unordered_set<std::string> callParameters;
-    for (const auto& callParam : call.parameters)
+    // Spec positions of parameters given in call.
+    ParameterSet callParameters(spec->parameters.size());
+    for (size_t i = 0; i < result.parameters.size(); ++i)
     {
-        if (callParam.name)
+        FunctionCallParameter& param = result.parameters[i];
+        if (!param.name)
         {
-            callParameters.insert(*callParam.name);
+            // Positional parameter.
+            const RegisteredFunctionSpecParameter& specParam = spec->parameters[i];
+            param.name = specParam.name.to_string();
+            param.nameId = specParam.nameId;
+            callParameters.insert(i);
+
+            continue;
         }
-    }
-    const FunctionSpec& spec = functionSpecs.at(call.name);
 
-    for (size_t i = 0; i < result.parameters.size(); ++i)
-    {
-        if (!result.parameters[i].name)
+        if (param.nameId == InvalidSymbolId)
+        {
+            param.nameId = symbols.find(*param.name);
+        }
+
+        const size_t position = findParameterPosition(*spec, param.nameId);
+        if (param.nameId != InvalidSymbolId && position < spec->parameters.size())
         {
-            result.parameters[i].name = spec.parameters[i].name;
+            callParameters.insert(position);
         }
     }
 
-    for (const auto& specParam : spec.parameters)
+    for (size_t i = 0; i < spec->parameters.size(); ++i)
     {
+        const RegisteredFunctionSpecParameter& specParam = spec->parameters[i];
         if (!specParam.value)
         {
             // No Default value.
@@ -75,11 +238,30 @@ FunctionCall FunctionRegistry::updateFunctionCall(const FunctionCall& call) cons
         }
 
         // if given parameter is absent in call, add it with default value.
-        if (callParameters.find(specParam.name) == callParameters.end())
+        if (!callParameters.contains(i))
         {
-            result.parameters.push_back(FunctionCallParameter{specParam.name, *specParam.value});
+            result.parameters.push_back(FunctionCallParameter{specParam.name.to_string(), specParam.value->to_string(),
+                    getLiteralValueType(*specParam.value), specParam.nameId});
         }
     }
 
+    EQUEUM_TRACE_PROBE3(call__bind, call.name.c_str(), call.parameters.size(), static_cast<int>(PARSE_ERROR_NONE));
+
     return result;
 }
+
+const SymbolTable& FunctionRegistry::getSymbolTable() const
+{
+    return symbols;
+}
+
+const RegisteredFunctionSpec* FunctionRegistry::findFunctionSpec(SymbolId functionNameId) const
+{
+    if (functionNameId == InvalidSymbolId || functionNameId >= functionSpecs.size()
+            || functionSpecs[functionNameId].nameId == InvalidSymbolId)
+    {
+        return nullptr;
+    }
+
+    return &functionSpecs[functionNameId];
+}
@@ -5,26 +5,78 @@
 #ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_REGISTRY_H_INCLUDED
 #define EQUEUM_FUNCTION_PARSER_FUNCTION_REGISTRY_H_INCLUDED
 
+#include "FunctionParser.h"
+#include "StaticFunctionSpec.h"
+#include "StringView.h"
+#include "SymbolTable.h"
+
+#include <boost/optional.hpp>
+
 #include <string>
-#include <unordered_map>
+#include <vector>
 
-struct FunctionSpec;
-struct FunctionCall;
+// Spec as stored in the FunctionRegistry. Names and default values are views of strings
+// interned in the registry's memory resource, they stay valid as long as the registry does.
+
+struct RegisteredFunctionSpecParameter
+{
+    boost::string_view name;
+    boost::optional<boost::string_view> value;
+    SymbolId nameId;
+};
+
+typedef SmallVector<RegisteredFunctionSpecParameter, EQUEUM_FUNCTION_PARSER_INLINE_PARAMETERS,
+        ResourceAllocator<RegisteredFunctionSpecParameter>> RegisteredFunctionSpecParameters;
+
+struct RegisteredFunctionSpec
+{
+    boost::string_view name;
+    RegisteredFunctionSpecParameters parameters;
+    SymbolId nameId;
+
+    /// Copy that uses the global heap.
+    FunctionSpec toFunctionSpec() const;
+};
 
 class FunctionRegistry
 {
 public:
-    FunctionRegistry();
+    /// Specs with their names and default values, and the symbol table are allocated
+    /// from resource, which must outlive the registry. Specs and calls given out by
+    /// getFunctionSpecByName() and updateFunctionCall() use the global heap.
+    explicit FunctionRegistry(MemoryResource* resource = getDefaultMemoryResource());
     ~FunctionRegistry();
 
     std::string addFunction(const std::string& functionSpecification);
+    /// Spec's nameId members are ignored.
+    std::string addFunction(const FunctionSpec& spec);
+    /// Registers spec parsed at compile time, without parsing anything at run time.
+    template <size_t MaxParameters>
+    std::string addFunction(const StaticFunctionSpec<MaxParameters>& spec)
+    {
+        return addFunction(spec.toFunctionSpec());
+    }
     FunctionSpec getFunctionSpecByName(const std::string& functionName) const;
+    /// nullptr if there is no such function, pointer is invalidated by addFunction().
+    const RegisteredFunctionSpec* findFunctionSpecByName(boost::string_view functionName) const;
     bool deleteFunctionSpecByName(const std::string& functionName);
 
+    /// Call's nameId members, if set, must come from getSymbolTable().
     FunctionCall updateFunctionCall(const FunctionCall& call) const;
 
+    /// Names of all functions and parameters ever registered.
+    /// Pass it to tryParseFunctionCall to get ids resolved while parsing.
+    const SymbolTable& getSymbolTable() const;
+
+private:
+    const RegisteredFunctionSpec* findFunctionSpec(SymbolId functionNameId) const;
+
 private:
-    std::unordered_map<std::string, FunctionSpec> functionSpecs;
+    SymbolTable symbols;
+    // Texts of default values, so that repeated ones like "0" are stored once.
+    SymbolTable values;
+    // Indexed by SymbolId of the function name, nameId is InvalidSymbolId for empty slots.
+    std::vector<RegisteredFunctionSpec, ResourceAllocator<RegisteredFunctionSpec>> functionSpecs;
 };
 
 #endif // EQUEUM_FUNCTION_PARSER_FUNCTION_REGISTRY_H_INCLUDED
@@ -0,0 +1,176 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionWriter.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+
+const uint64_t LowBits = 0x0101010101010101ull;
+const uint64_t HighBits = 0x8080808080808080ull;
+
+/// Non-zero if any byte of the word is zero.
+inline uint64_t hasZeroByte(uint64_t word)
+{
+    return (word - LowBits) & ~word & HighBits;
+}
+
+/// Non-zero if any byte of the word is a quote or a backslash.
+inline uint64_t hasByteToEscape(uint64_t word)
+{
+    return hasZeroByte(word ^ (LowBits * '"')) | hasZeroByte(word ^ (LowBits * '\\'));
+}
+
+/// Appends without capacity checks, space must be reserved by resizing the output beforehand.
+class UncheckedWriter
+{
+public:
+    explicit UncheckedWriter(char* position)
+        : position(position)
+    {}
+
+    void write(boost::string_view str)
+    {
+        std::memcpy(position, str.data(), str.size());
+        position += str.size();
+    }
+
+    void write(char c)
+    {
+        *position++ = c;
+    }
+
+private:
+    char* position;
+};
+
+/// Resizes output to fit extra size bytes, returns pointer to the first of them.
+char* grow(std::string& output, size_t size)
+{
+    const size_t oldSize = output.size();
+    output.resize(oldSize + size);
+
+    return &output[oldSize];
+}
+
+} // namespace
+
+void writeFunctionCall(const FunctionCall& call, std::string& output)
+{
+    // name(a, b=1)
+    size_t size = call.name.size() + 2;
+    for (const auto& param : call.parameters)
+    {
+        size += param.value.size() + (param.name ? param.name->size() + 1 : 0);
+    }
+    size += call.parameters.empty() ? 0 : (call.parameters.size() - 1) * 2;
+
+    UncheckedWriter writer(grow(output, size));
+    writer.write(call.name);
+    writer.write('(');
+    for (size_t i = 0; i < call.parameters.size(); ++i)
+    {
+        const FunctionCallParameter& param = call.parameters[i];
+        if (i != 0)
+        {
+            writer.write(", ");
+        }
+        if (param.name)
+        {
+            writer.write(*param.name);
+            writer.write('=');
+        }
+        writer.write(param.value);
+    }
+    writer.write(')');
+}
+
+void writeFunctionSpec(const FunctionSpec& spec, std::string& output)
+{
+    size_t size = spec.name.size() + 2;
+    for (const auto& param : spec.parameters)
+    {
+        size += param.name.size() + (param.value ? param.value->size() + 1 : 0);
+    }
+    size += spec.parameters.empty() ? 0 : (spec.parameters.size() - 1) * 2;
+
+    UncheckedWriter writer(grow(output, size));
+    writer.write(spec.name);
+    writer.write('(');
+    for (size_t i = 0; i < spec.parameters.size(); ++i)
+    {
+        const FunctionSpecParameter& param = spec.parameters[i];
+        if (i != 0)
+        {
+            writer.write(", ");
+        }
+        writer.write(param.name);
+        if (param.value)
+        {
+            writer.write('=');
+            writer.write(*param.value);
+        }
+    }
+    writer.write(')');
+}
+
+std::string formatFunctionCall(const FunctionCall& call)
+{
+    std::string result;
+    writeFunctionCall(call, result);
+
+    return result;
+}
+
+std::string formatFunctionSpec(const FunctionSpec& spec)
+{
+    std::string result;
+    writeFunctionSpec(spec, result);
+
+    return result;
+}
+
+void writeStringLiteral(boost::string_view value, std::string& output)
+{
+    output.reserve(output.size() + value.size() + 2);
+    output.push_back('"');
+
+    // Copies runs of characters that need no escaping in bulk, finding them 8 bytes at a time.
+    const char* const begin = value.data();
+    const char* const end = begin + value.size();
+    const char* runBegin = begin;
+    const char* p = begin;
+    while (p != end)
+    {
+        if (static_cast<size_t>(end - p) >= sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if (!hasByteToEscape(word))
+            {
+                p += sizeof(word);
+                continue;
+            }
+        }
+
+        // Somewhere in the next 8 bytes, or in the tail.
+        const char* const blockEnd = (static_cast<size_t>(end - p) >= sizeof(uint64_t)) ? p + sizeof(uint64_t) : end;
+        for (; p != blockEnd; ++p)
+        {
+            if (*p == '"' || *p == '\\')
+            {
+                output.append(runBegin, p);
+                output.push_back('\\');
+                runBegin = p;
+            }
+        }
+    }
+
+    output.append(runBegin, end);
+    output.push_back('"');
+}
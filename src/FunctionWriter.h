@@ -0,0 +1,30 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_FUNCTION_WRITER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_FUNCTION_WRITER_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "StringView.h"
+
+#include <string>
+
+/// Canonical text of calls and specs, parseable back by parseFunctionCall and parseFunctionSpec:
+///
+///     function(1, 2.5, c=3, d="foo")
+///
+/// Values are written as is, they are literals or source text of expressions already.
+/// write* functions append to the output, growing it at most once.
+void writeFunctionCall(const FunctionCall& call, std::string& output);
+void writeFunctionSpec(const FunctionSpec& spec, std::string& output);
+
+std::string formatFunctionCall(const FunctionCall& call);
+std::string formatFunctionSpec(const FunctionSpec& spec);
+
+/// Appends value as a quoted string literal, escaping quotes and backslashes.
+/// Inverse of unescapeStringLiteral.
+void writeStringLiteral(boost::string_view value, std::string& output);
+
+#endif // EQUEUM_FUNCTION_PARSER_FUNCTION_WRITER_H_INCLUDED
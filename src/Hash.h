@@ -0,0 +1,51 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_HASH_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_HASH_H_INCLUDED
+
+#include "StringView.h"
+
+#include <cstdint>
+#include <cstring>
+
+inline uint64_t mixHash(uint64_t value)
+{
+    // splitmix64 finalizer
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ull;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBull;
+    value ^= value >> 31;
+
+    return value;
+}
+
+/// Fast non-cryptographic hash, consumes input 8 bytes at a time.
+/// Not stable across platforms with different endianness, don't persist it.
+inline uint64_t hashBytes(boost::string_view data, uint64_t seed = 0)
+{
+    const uint64_t Multiplier = 0x9E3779B97F4A7C15ull;
+
+    uint64_t result = seed ^ (data.size() * Multiplier);
+    const char* p = data.data();
+    size_t size = data.size();
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), p += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        result = mixHash(result ^ word) * Multiplier;
+    }
+
+    uint64_t tail = 0;
+    if (size != 0)
+    {
+        std::memcpy(&tail, p, size);
+    }
+
+    return mixHash(result ^ tail);
+}
+
+#endif // EQUEUM_FUNCTION_PARSER_HASH_H_INCLUDED
@@ -0,0 +1,99 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_INLINE_RING_BUFFER_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_INLINE_RING_BUFFER_H_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+/// FIFO queue that keeps up to InlineCapacity elements inside the object and
+/// spills to the heap, doubling capacity, only when more are queued at once.
+/// Heap memory, once allocated, is kept until destruction.
+/// T must be default constructible and copy assignable.
+template <typename T, size_t InlineCapacity>
+class InlineRingBuffer
+{
+    static_assert(InlineCapacity > 0 && (InlineCapacity & (InlineCapacity - 1)) == 0,
+            "InlineCapacity must be a power of two.");
+
+public:
+    InlineRingBuffer()
+        : data(inlineData),
+          capacity(InlineCapacity),
+          head(0),
+          count(0)
+    {}
+
+    // data may point into the object itself.
+    InlineRingBuffer(const InlineRingBuffer&) = delete;
+    InlineRingBuffer& operator=(const InlineRingBuffer&) = delete;
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    T& front()
+    {
+        assert(count != 0);
+        return data[head];
+    }
+
+    void push_back(const T& value)
+    {
+        if (count == capacity)
+        {
+            grow();
+        }
+
+        data[(head + count) & (capacity - 1)] = value;
+        ++count;
+    }
+
+    void pop_front()
+    {
+        assert(count != 0);
+        head = (head + 1) & (capacity - 1);
+        --count;
+    }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    void grow()
+    {
+        std::unique_ptr<T[]> grown(new T[capacity * 2]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            grown[i] = data[(head + i) & (capacity - 1)];
+        }
+
+        heapData = std::move(grown);
+        data = heapData.get();
+        capacity *= 2;
+        head = 0;
+    }
+
+private:
+    T inlineData[InlineCapacity];
+    std::unique_ptr<T[]> heapData;
+    T* data;
+    size_t capacity; // always a power of two.
+    size_t head;
+    size_t count;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_INLINE_RING_BUFFER_H_INCLUDED
@@ -0,0 +1,156 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifdef EQUEUM_FUNCTION_PARSER_INSTRUMENTATION
+
+namespace
+{
+
+/// Written only by the owning thread, atomic so that snapshots may read them concurrently.
+struct ThreadCounters
+{
+    std::atomic<uint64_t> count[INSTRUMENTATION_POINT_COUNT];
+    std::atomic<uint64_t> bytes[INSTRUMENTATION_POINT_COUNT];
+    std::atomic<uint64_t> nanoseconds[INSTRUMENTATION_POINT_COUNT];
+};
+
+void add(std::atomic<uint64_t>& counter, uint64_t value)
+{
+    // Single writer, so no need for read-modify-write.
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void addToSnapshot(const ThreadCounters& counters, InstrumentationSnapshot& snapshot)
+{
+    for (size_t i = 0; i < INSTRUMENTATION_POINT_COUNT; ++i)
+    {
+        snapshot.counters[i].count += counters.count[i].load(std::memory_order_relaxed);
+        snapshot.counters[i].bytes += counters.bytes[i].load(std::memory_order_relaxed);
+        snapshot.counters[i].nanoseconds += counters.nanoseconds[i].load(std::memory_order_relaxed);
+    }
+}
+
+/// Counters of live threads and totals of finished ones.
+class CounterRegistry
+{
+public:
+    CounterRegistry()
+        : finished{}
+    {}
+
+    void add(const ThreadCounters* counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(counters);
+    }
+
+    void remove(const ThreadCounters* counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        addToSnapshot(*counters, finished);
+        threads.erase(std::find(threads.begin(), threads.end(), counters));
+    }
+
+    InstrumentationSnapshot getSnapshot()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        InstrumentationSnapshot result = finished;
+        for (const ThreadCounters* counters : threads)
+        {
+            addToSnapshot(*counters, result);
+        }
+
+        return result;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<const ThreadCounters*> threads;
+    InstrumentationSnapshot finished;
+};
+
+CounterRegistry& getCounterRegistry()
+{
+    // Never destroyed, threads may finish after static destructors have run.
+    static CounterRegistry* registry = new CounterRegistry;
+    return *registry;
+}
+
+class ThreadCountersHolder
+{
+public:
+    ThreadCountersHolder()
+        : counters{}
+    {
+        getCounterRegistry().add(&counters);
+    }
+
+    ~ThreadCountersHolder()
+    {
+        getCounterRegistry().remove(&counters);
+    }
+
+    ThreadCounters counters;
+};
+
+} // namespace
+
+void recordInstrumentation(InstrumentationPoint point, uint64_t bytes, uint64_t nanoseconds)
+{
+    thread_local ThreadCountersHolder holder;
+
+    add(holder.counters.count[point], 1);
+    add(holder.counters.bytes[point], bytes);
+    add(holder.counters.nanoseconds[point], nanoseconds);
+}
+
+bool isInstrumentationEnabled()
+{
+    return true;
+}
+
+InstrumentationSnapshot getInstrumentationSnapshot()
+{
+    return getCounterRegistry().getSnapshot();
+}
+
+#else
+
+bool isInstrumentationEnabled()
+{
+    return false;
+}
+
+InstrumentationSnapshot getInstrumentationSnapshot()
+{
+    return InstrumentationSnapshot{};
+}
+
+#endif // EQUEUM_FUNCTION_PARSER_INSTRUMENTATION
+
+const char* getInstrumentationPointName(InstrumentationPoint point)
+{
+    switch (point)
+    {
+        case INSTRUMENTATION_GET_NEXT_TOKEN:
+            return "get_next_token";
+        case INSTRUMENTATION_GET_NEXT_LEXEME:
+            return "get_next_lexeme";
+        case INSTRUMENTATION_PARSE_FUNCTION_CALL:
+            return "parse_function_call";
+        case INSTRUMENTATION_UPDATE_FUNCTION_CALL:
+            return "update_function_call";
+        case INSTRUMENTATION_POINT_COUNT:
+            break;
+    }
+    return "unknown";
+}
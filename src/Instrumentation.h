@@ -0,0 +1,92 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_INSTRUMENTATION_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_INSTRUMENTATION_H_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Counters of the hot paths of the library, enabled with CMake option FUNCTION_PARSER_INSTRUMENTATION.
+// When disabled, hooks compile to nothing and snapshots are all zeros.
+
+enum InstrumentationPoint : int
+{
+    INSTRUMENTATION_GET_NEXT_TOKEN, // Tokenizer::getNextToken, bytes of tokens
+    INSTRUMENTATION_GET_NEXT_LEXEME, // Lexer::getNextLexeme, bytes of lexemes
+    INSTRUMENTATION_PARSE_FUNCTION_CALL, // parsing a call by any API, bytes of input
+    INSTRUMENTATION_UPDATE_FUNCTION_CALL, // FunctionRegistry::updateFunctionCall, no bytes
+
+    INSTRUMENTATION_POINT_COUNT
+};
+
+struct InstrumentationCounters
+{
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t nanoseconds; // total latency
+};
+
+/// Totals since the start of the process over all threads, including finished ones.
+/// Counters only grow, take difference of two snapshots to get rates.
+struct InstrumentationSnapshot
+{
+    InstrumentationCounters counters[INSTRUMENTATION_POINT_COUNT];
+};
+
+bool isInstrumentationEnabled();
+const char* getInstrumentationPointName(InstrumentationPoint point);
+/// Safe to call from any thread, doesn't block threads that record counters.
+InstrumentationSnapshot getInstrumentationSnapshot();
+
+#ifdef EQUEUM_FUNCTION_PARSER_INSTRUMENTATION
+
+/// Adds to the counters of the current thread.
+void recordInstrumentation(InstrumentationPoint point, uint64_t bytes, uint64_t nanoseconds);
+
+/// Records a call and its latency on destruction.
+class InstrumentationScope
+{
+public:
+    explicit InstrumentationScope(InstrumentationPoint point)
+        : point(point),
+          bytes(0),
+          start(std::chrono::steady_clock::now())
+    {}
+
+    ~InstrumentationScope()
+    {
+        const auto latency = std::chrono::steady_clock::now() - start;
+        recordInstrumentation(point, bytes,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    }
+
+    InstrumentationScope(const InstrumentationScope&) = delete;
+    InstrumentationScope& operator=(const InstrumentationScope&) = delete;
+
+    void addBytes(size_t size)
+    {
+        bytes += size;
+    }
+
+private:
+    const InstrumentationPoint point;
+    uint64_t bytes;
+    const std::chrono::steady_clock::time_point start;
+};
+
+#define EQUEUM_INSTRUMENTATION_SCOPE(scope, point) InstrumentationScope scope(point)
+#define EQUEUM_INSTRUMENTATION_BYTES(scope, size) scope.addBytes(size)
+
+#else
+
+// Arguments are not evaluated.
+#define EQUEUM_INSTRUMENTATION_SCOPE(scope, point) do {} while (false)
+#define EQUEUM_INSTRUMENTATION_BYTES(scope, size) do {} while (false)
+
+#endif // EQUEUM_FUNCTION_PARSER_INSTRUMENTATION
+
+#endif // EQUEUM_FUNCTION_PARSER_INSTRUMENTATION_H_INCLUDED
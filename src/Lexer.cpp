@@ -5,12 +5,11 @@
 
 #include "Lexer.h"
 
+#include "Instrumentation.h"
 #include "Tokenizer.h"
+#include "Tracing.h"
 
 #include <cassert>
-#include <deque>
-#include <vector>
-#include <memory>
 
 namespace
 {
@@ -22,6 +21,7 @@ bool isTerminalToken(const Token& token)
             || token.type == TOKEN_LPAR
             || token.type == TOKEN_RPAR
             || token.type == TOKEN_QUOTED_STRING
+            || token.type == TOKEN_UNTERMINATED_STRING
             || token.type == TOKEN_OP
             || (token.type == TOKEN_PUNCT && token.value != ".");
 }
@@ -51,63 +51,87 @@ LexemeType convertTokenTypeToLexemeType(TokenType tokenType)
         default:
             assert(false && "Unsupported token type.");
     }
+    return LEX_ERROR;
 }
 
 class LexemeBuilder
 {
 public:
-    LexemeBuilder(LexemeType type)
-        : type(type)
+    LexemeBuilder(LexemeType type, ParseErrorCode errorCode)
+        : type(type),
+          errorCode(errorCode)
     {}
 
     virtual ~LexemeBuilder()
     {}
 
+    /// Returns false when token can't be a part of the Lexeme.
+    virtual bool consumeToken(const Token& token) = 0;
+
     /// Returns true when Lexeme can be produced.
-    virtual void consumeToken(const Token& token) = 0;
+    bool isComplete() const
+    {
+        return canProduceLexeme;
+    }
 
-    Lexeme produceLexeme()
+    /// Error to report when token is rejected or Lexeme is incomplete.
+    ParseErrorCode getErrorCode() const
     {
-        if (!canProduceLexeme)
-        {
-            assert(false && "LexemeBuilder is not ready to produce a Lexeme"
-                    " (not enought input?).");
-        }
+        return errorCode;
+    }
+
+    Lexeme produceLexeme(size_t offset)
+    {
+        assert(canProduceLexeme && "LexemeBuilder is not ready to produce a Lexeme"
+                " (not enought input?).");
+
+        // Tokens of a Lexeme are adjacent in the input.
+        const boost::string_view value(first.value.data(),
+                last.value.data() + last.value.size() - first.value.data());
 
-        std::string value;
-        for (const auto& t : accumulatedTokens)
+        return Lexeme{value, type, offset};
+    }
+
+protected:
+    void accumulateToken(const Token& token)
+    {
+        if (!hasTokens)
         {
-            value += t.value.to_string();
+            first = token;
+            hasTokens = true;
         }
-
-        return Lexeme{value, type};
+        last = token;
     }
 
 protected:
     bool canProduceLexeme = false;
-    std::deque<Token> accumulatedTokens;
+    // Only the bounds of accumulated tokens are needed to produce the Lexeme.
+    bool hasTokens = false;
+    Token first{};
+    Token last{};
     const LexemeType type;
+    const ParseErrorCode errorCode;
 };
 
 class NameLexemeBuilder : public LexemeBuilder
 {
 public:
     NameLexemeBuilder()
-        : LexemeBuilder(LEX_NAME)
+        : LexemeBuilder(LEX_NAME, PARSE_ERROR_INVALID_NAME)
     {
     }
 
-    void consumeToken(const Token& token) override
+    bool consumeToken(const Token& token) override
     {
         if (token.type == TOKEN_STRING || token.type == TOKEN_NUMBER)
         {
-            accumulatedTokens.push_back(token);
+            accumulateToken(token);
             canProduceLexeme = true;
+
+            return true;
         }
-        else
-        {
-            assert(false && "Unsupported token type for LEX_NAME");
-        }
+
+        return false;
     }
 };
 
@@ -115,61 +139,123 @@ class NumberLexemeBuilder : public LexemeBuilder
 {
 public:
     NumberLexemeBuilder()
-            : LexemeBuilder(LEX_NUMBER_LITERAL)
+            : LexemeBuilder(LEX_NUMBER_LITERAL, PARSE_ERROR_INVALID_NUMBER)
     {
     }
 
-    void consumeToken(const Token& token) override
+    bool consumeToken(const Token& token) override
     {
         if (token.type == TOKEN_PUNCT && token.value == ".")
         {
-            if (dots_allowed)
+            if (!dots_allowed)
             {
-                accumulatedTokens.push_back(token);
-                --dots_allowed;
-                canProduceLexeme = false;
-            }
-            else
-            {
-                assert(false && "Multiple decimal dots in a number.");
+                // Multiple decimal dots in a number.
+                return false;
             }
+
+            accumulateToken(token);
+            --dots_allowed;
+            canProduceLexeme = false;
+
+            return true;
         }
 
         if (token.type == TOKEN_NUMBER)
         {
-            accumulatedTokens.push_back(token);
+            accumulateToken(token);
             canProduceLexeme = true;
+
+            return true;
         }
+
+        return false;
     }
 private:
     size_t dots_allowed = 1;
 };
 
-LexemeBuilder* makeLexemeBuilder(const Token& token)
+/// Builders of all lexemes that span several tokens, kept on the stack to avoid allocating.
+struct LexemeBuilders
+{
+    NumberLexemeBuilder number;
+    NameLexemeBuilder name;
+};
+
+/// Returns nullptr if there is no Lexeme that can start with given token.
+LexemeBuilder* selectLexemeBuilder(const Token& token, LexemeBuilders& builders)
 {
     switch (token.type)
     {
         case TOKEN_NUMBER:
-            return new NumberLexemeBuilder();
+            return &builders.number;
         case TOKEN_STRING:
-            return new NameLexemeBuilder();
+            return &builders.name;
         default:
-            assert(false && "No builder for given Token type.");
+            return nullptr;
     }
-    return nullptr;
 }
 
 } // namespace
 
-Lexer::Lexer(std::string _input)
-    : input(std::move(_input)),
-      tokenizer(input)
-{}
+Lexer::Lexer(boost::string_view input, const ParseLimits& limits)
+    : input(input),
+      tokenizer(input),
+      error(PARSE_ERROR_NONE),
+      errorOffset(0),
+      limits(limits),
+      lexemeCount(0)
+{
+    if (input.size() > limits.maxInputLength)
+    {
+        error = PARSE_ERROR_INPUT_TOO_LONG;
+        errorOffset = limits.maxInputLength;
+    }
+}
 
 Lexer::~Lexer()
 {}
 
 Lexeme Lexer::getNextLexeme()
+{
+    EQUEUM_INSTRUMENTATION_SCOPE(scope, INSTRUMENTATION_GET_NEXT_LEXEME);
+    if (error != PARSE_ERROR_NONE)
+    {
+        return Lexeme{boost::string_view(), LEX_ERROR, errorOffset};
+    }
+
+    const Lexeme result = checkLimits(scanLexeme());
+    EQUEUM_INSTRUMENTATION_BYTES(scope, result.value.size());
+    EQUEUM_TRACE_PROBE3(lexeme, static_cast<int>(result.type), result.offset, result.value.size());
+
+    return result;
+}
+
+ParseErrorCode Lexer::getError() const
+{
+    return error;
+}
+
+Lexeme Lexer::checkLimits(const Lexeme& lexeme)
+{
+    if (lexeme.type == LEX_ERROR || lexeme.type == LEX_END_OF_INPUT)
+    {
+        return lexeme;
+    }
+
+    if (++lexemeCount > limits.maxLexemeCount)
+    {
+        return buildErrorLexeme(PARSE_ERROR_TOO_MANY_LEXEMES, lexeme.offset);
+    }
+    if ((lexeme.type == LEX_STRING_LITERAL || lexeme.type == LEX_NUMBER_LITERAL)
+            && lexeme.value.size() > limits.maxLiteralLength)
+    {
+        return buildErrorLexeme(PARSE_ERROR_LITERAL_TOO_LONG, lexeme.offset);
+    }
+
+    return lexeme;
+}
+
+Lexeme Lexer::scanLexeme()
 {
     Token nextToken = tokenizer.peekNextToken();
     while(nextToken.type != TOKEN_END_OF_INPUT)
@@ -204,21 +290,34 @@ Lexeme Lexer::buildLexeme()
 {
     if (stack.empty())
     {
-        //assert(false && "Can't build Lexeme from empty tokens stack.");
-        return Lexeme{std::string(), LEX_END_OF_INPUT};
+        return Lexeme{boost::string_view(), LEX_END_OF_INPUT, input.size()};
     }
 
     Token token = stack.front();
     stack.pop_front();
+    const size_t offset = getOffset(token);
+    if (token.type == TOKEN_UNTERMINATED_STRING)
+    {
+        return buildErrorLexeme(PARSE_ERROR_UNTERMINATED_STRING, offset);
+    }
     if (isTerminalToken(token))
     {
-        return Lexeme{token.value.to_string(), convertTokenTypeToLexemeType(token.type)};
+        return Lexeme{token.value, convertTokenTypeToLexemeType(token.type), offset};
+    }
+
+    LexemeBuilders builders;
+    LexemeBuilder* lexemeBuilder = selectLexemeBuilder(token, builders);
+    if (!lexemeBuilder)
+    {
+        return buildErrorLexeme(PARSE_ERROR_UNEXPECTED_CHARACTER, offset);
     }
 
-    std::unique_ptr<LexemeBuilder> lexemeBuilder(makeLexemeBuilder(token));
     do
     {
-        lexemeBuilder->consumeToken(token);
+        if (!lexemeBuilder->consumeToken(token))
+        {
+            return buildErrorLexeme(lexemeBuilder->getErrorCode(), getOffset(token));
+        }
         if (stack.empty() || isTerminalToken(stack.front()))
         {
             break;
@@ -229,5 +328,24 @@ Lexeme Lexer::buildLexeme()
     }
     while (true);
 
-    return lexemeBuilder->produceLexeme();
+    if (!lexemeBuilder->isComplete())
+    {
+        return buildErrorLexeme(lexemeBuilder->getErrorCode(), offset);
+    }
+
+    return lexemeBuilder->produceLexeme(offset);
+}
+
+Lexeme Lexer::buildErrorLexeme(ParseErrorCode errorCode, size_t offset)
+{
+    stack.clear();
+    error = errorCode;
+    errorOffset = offset;
+
+    return Lexeme{boost::string_view(), LEX_ERROR, errorOffset};
+}
+
+size_t Lexer::getOffset(const Token& token) const
+{
+    return token.value.data() - input.data();
 }
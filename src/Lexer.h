@@ -6,9 +6,11 @@
 #ifndef EQUEUM_FUNCTION_PARSER_LEXER_H_INCLUDED
 #define EQUEUM_FUNCTION_PARSER_LEXER_H_INCLUDED
 
+#include "InlineRingBuffer.h"
+#include "ParseError.h"
+#include "ParseLimits.h"
 #include "Tokenizer.h"
 
-#include <deque>
 #include <exception>
 #include <string>
 
@@ -20,17 +22,21 @@ enum LexemeType : int
     LEX_STRING_LITERAL, // quoted string
     LEX_NAME, //
     LEX_OPERATOR, // +, -, *, /, =
-    LEX_PUNCTUATION, // ,.:;
+    LEX_PUNCTUATION, // ,.:;?
     LEX_LEFT_PARENTHESIS, // (
     LEX_RIGHT_PARENTHESIS, // )
+    LEX_EXPRESSION, // several lexemes forming an argument expression, made by parser, not by Lexer.
+    LEX_PLACEHOLDER, // '?' argument of a call template, made by parser, not by Lexer.
 
-    LEX_END_OF_INPUT
+    LEX_END_OF_INPUT,
+    LEX_ERROR // malformed input, see Lexer::getError() for details.
 };
 
 struct Lexeme
 {
-    std::string value;
+    boost::string_view value; // points into the Lexer's input.
     LexemeType type;
+    size_t offset; // byte offset of the first character in the input.
 };
 
 class Tokenizer;
@@ -38,18 +44,32 @@ class Tokenizer;
 class Lexer
 {
 public:
-    explicit Lexer(std::string input);
+    /// input must outlive the Lexer, it is not copied.
+    explicit Lexer(boost::string_view input, const ParseLimits& limits = DefaultParseLimits);
     ~Lexer();
 
+    /// Once LEX_ERROR is returned, all subsequent calls return it too.
+    /// Each call consumes at least one token, the whole input is read in linear time.
     Lexeme getNextLexeme();
+    ParseErrorCode getError() const;
+
 protected:
+    Lexeme scanLexeme();
+    Lexeme checkLimits(const Lexeme& lexeme);
     void pushToken(const Token& token);
     Lexeme buildLexeme();
+    Lexeme buildErrorLexeme(ParseErrorCode errorCode, size_t offset);
+    size_t getOffset(const Token& token) const;
 
 private:
-    std::string input;
+    boost::string_view input;
     Tokenizer tokenizer;
-    std::deque<Token> stack;
+    // Non-terminal tokens of the next lexeme, usually just a few: "1.5" is three tokens.
+    InlineRingBuffer<Token, 8> stack;
+    ParseErrorCode error;
+    size_t errorOffset;
+    const ParseLimits limits;
+    size_t lexemeCount;
 };
 
 #endif // EQUEUM_FUNCTION_PARSER_LEXER_H_INCLUDED
@@ -0,0 +1,91 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+class FileDescriptorGuard
+{
+public:
+    explicit FileDescriptorGuard(int fd)
+        : fd(fd)
+    {}
+
+    ~FileDescriptorGuard()
+    {
+        ::close(fd);
+    }
+
+private:
+    const int fd;
+};
+
+std::system_error makeSystemError(const std::string& what, const std::string& path)
+{
+    return std::system_error(errno, std::generic_category(), what + " \"" + path + "\"");
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& path)
+    : data(nullptr),
+      size(0)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw makeSystemError("Failed to open", path);
+    }
+    FileDescriptorGuard fdGuard(fd);
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0)
+    {
+        throw makeSystemError("Failed to stat", path);
+    }
+
+    size = static_cast<size_t>(fileStat.st_size);
+    if (size == 0)
+    {
+        // Empty mappings are not allowed.
+        return;
+    }
+
+    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        throw makeSystemError("Failed to mmap", path);
+    }
+
+    // Input is split into chunks parsed concurrently, but each chunk is scanned front to back
+    // exactly once by one thread. With sequential advice every page fault reads ahead from its
+    // own offset, so each reader gets readahead without sharing the file's readahead window,
+    // and parsed pages are reclaimed first since nothing reads them again.
+    ::madvise(data, size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+    {
+        ::munmap(data, size);
+    }
+}
+
+boost::string_view MappedFile::getData() const
+{
+    return boost::string_view(static_cast<const char*>(data), size);
+}
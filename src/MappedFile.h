@@ -0,0 +1,33 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_MAPPED_FILE_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_MAPPED_FILE_H_INCLUDED
+
+#include "StringView.h"
+
+#include <cstddef>
+#include <string>
+
+/// Read-only memory mapping of the whole file.
+class MappedFile
+{
+public:
+    /// Throws std::system_error if file can't be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Valid for the lifetime of the MappedFile.
+    boost::string_view getData() const;
+
+private:
+    void* data;
+    size_t size;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_MAPPED_FILE_H_INCLUDED
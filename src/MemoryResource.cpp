@@ -0,0 +1,154 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "MemoryResource.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace
+{
+
+class NewDeleteMemoryResource : public MemoryResource
+{
+protected:
+    void* doAllocate(size_t bytes, size_t /*alignment*/) override
+    {
+        return ::operator new(bytes);
+    }
+
+    void doDeallocate(void* p, size_t /*bytes*/, size_t /*alignment*/) override
+    {
+        ::operator delete(p);
+    }
+
+    bool doIsEqual(const MemoryResource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+const size_t MinimumBlockSize = 256;
+
+size_t getPadding(const char* p, size_t alignment)
+{
+    const size_t misalignment = reinterpret_cast<uintptr_t>(p) & (alignment - 1);
+    return misalignment == 0 ? 0 : alignment - misalignment;
+}
+
+} // namespace
+
+MemoryResource::~MemoryResource()
+{}
+
+void* MemoryResource::allocate(size_t bytes, size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    assert(alignment <= alignof(std::max_align_t));
+
+    return doAllocate(bytes, alignment);
+}
+
+void MemoryResource::deallocate(void* p, size_t bytes, size_t alignment)
+{
+    doDeallocate(p, bytes, alignment);
+}
+
+bool MemoryResource::isEqual(const MemoryResource& other) const noexcept
+{
+    return doIsEqual(other);
+}
+
+MemoryResource* getDefaultMemoryResource() noexcept
+{
+    // Never destroyed, containers with static storage duration may deallocate after static destructors have run.
+    static NewDeleteMemoryResource* resource = new NewDeleteMemoryResource;
+    return resource;
+}
+
+// Header at the start of each block taken from upstream, keeps memory max-aligned after it.
+struct alignas(std::max_align_t) MonotonicMemoryResource::Block
+{
+    Block* previous;
+    size_t size;
+};
+
+MonotonicMemoryResource::MonotonicMemoryResource(size_t initialSize, MemoryResource* upstream)
+    : upstream(upstream),
+      blocks(nullptr),
+      initialBuffer(nullptr),
+      initialBufferSize(0),
+      current(nullptr),
+      available(0),
+      initialBlockSize(std::max(initialSize, MinimumBlockSize)),
+      nextBlockSize(initialBlockSize)
+{}
+
+MonotonicMemoryResource::MonotonicMemoryResource(void* buffer, size_t size, MemoryResource* upstream)
+    : upstream(upstream),
+      blocks(nullptr),
+      initialBuffer(static_cast<char*>(buffer)),
+      initialBufferSize(size),
+      current(initialBuffer),
+      available(size),
+      initialBlockSize(std::max(size * 2, MinimumBlockSize)),
+      nextBlockSize(initialBlockSize)
+{}
+
+MonotonicMemoryResource::~MonotonicMemoryResource()
+{
+    release();
+}
+
+void MonotonicMemoryResource::release()
+{
+    while (blocks)
+    {
+        Block* previous = blocks->previous;
+        upstream->deallocate(blocks, blocks->size, alignof(Block));
+        blocks = previous;
+    }
+
+    current = initialBuffer;
+    available = initialBufferSize;
+    nextBlockSize = initialBlockSize;
+}
+
+void* MonotonicMemoryResource::doAllocate(size_t bytes, size_t alignment)
+{
+    size_t padding = getPadding(current, alignment);
+    if (!current || available < bytes || available - bytes < padding)
+    {
+        addBlock(bytes);
+        padding = 0;
+    }
+
+    char* result = current + padding;
+    current = result + bytes;
+    available -= padding + bytes;
+
+    return result;
+}
+
+void MonotonicMemoryResource::doDeallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/)
+{}
+
+bool MonotonicMemoryResource::doIsEqual(const MemoryResource& other) const noexcept
+{
+    return this == &other;
+}
+
+void MonotonicMemoryResource::addBlock(size_t minimumSize)
+{
+    const size_t size = std::max(nextBlockSize, sizeof(Block) + minimumSize);
+    Block* block = new (upstream->allocate(size, alignof(Block))) Block{blocks, size};
+
+    blocks = block;
+    current = reinterpret_cast<char*>(block + 1);
+    available = size - sizeof(Block);
+    nextBlockSize = size * 2;
+}
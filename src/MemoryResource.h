@@ -0,0 +1,134 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_MEMORY_RESOURCE_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_MEMORY_RESOURCE_H_INCLUDED
+
+#include <cstddef>
+
+/// Source of memory for the library's containers, same as std::pmr::memory_resource
+/// which is not available in C++14. Implement it to put memory into pools, arenas, etc.
+/// Alignment is at most alignof(std::max_align_t).
+class MemoryResource
+{
+public:
+    virtual ~MemoryResource();
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t));
+    /// True if memory allocated by one can be deallocated by the other.
+    bool isEqual(const MemoryResource& other) const noexcept;
+
+protected:
+    virtual void* doAllocate(size_t bytes, size_t alignment) = 0;
+    virtual void doDeallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual bool doIsEqual(const MemoryResource& other) const noexcept = 0;
+};
+
+/// Global operator new and delete, used unless a resource is given explicitly. Never destroyed.
+MemoryResource* getDefaultMemoryResource() noexcept;
+
+/// Hands out memory from a growing chain of blocks and releases it all at once,
+/// deallocate() does nothing. Suits short-lived data, e.g. everything parsed
+/// while handling a single request. Not thread-safe.
+class MonotonicMemoryResource : public MemoryResource
+{
+public:
+    /// Blocks are taken from upstream, the first one has initialSize bytes, each next is twice bigger.
+    explicit MonotonicMemoryResource(size_t initialSize = 1024,
+            MemoryResource* upstream = getDefaultMemoryResource());
+    /// Starts with buffer, e.g. on the stack, which must outlive the resource.
+    MonotonicMemoryResource(void* buffer, size_t size,
+            MemoryResource* upstream = getDefaultMemoryResource());
+    ~MonotonicMemoryResource() override;
+
+    MonotonicMemoryResource(const MonotonicMemoryResource&) = delete;
+    MonotonicMemoryResource& operator=(const MonotonicMemoryResource&) = delete;
+
+    /// Returns all blocks to upstream, memory allocated so far must no longer be used.
+    /// Initial buffer, if any, is reused.
+    void release();
+
+protected:
+    void* doAllocate(size_t bytes, size_t alignment) override;
+    void doDeallocate(void* p, size_t bytes, size_t alignment) override;
+    bool doIsEqual(const MemoryResource& other) const noexcept override;
+
+private:
+    struct Block;
+
+    void addBlock(size_t minimumSize);
+
+private:
+    MemoryResource* upstream;
+    Block* blocks;
+    char* initialBuffer;
+    size_t initialBufferSize;
+    char* current;
+    size_t available;
+    size_t initialBlockSize;
+    size_t nextBlockSize;
+};
+
+/// Allocator for standard and library containers that takes memory from a MemoryResource,
+/// like std::pmr::polymorphic_allocator. Default constructed one uses getDefaultMemoryResource().
+/// Allocator is not propagated on container copy, move or swap: copy of a container
+/// uses the default resource, so data outliving the resource can be copied out of it.
+template <typename T>
+class ResourceAllocator
+{
+public:
+    typedef T value_type;
+
+    ResourceAllocator() noexcept
+        : resource(getDefaultMemoryResource())
+    {}
+
+    ResourceAllocator(MemoryResource* resource) noexcept
+        : resource(resource)
+    {}
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) noexcept
+        : resource(other.getResource())
+    {}
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t count)
+    {
+        resource->deallocate(p, count * sizeof(T), alignof(T));
+    }
+
+    ResourceAllocator select_on_container_copy_construction() const
+    {
+        return ResourceAllocator();
+    }
+
+    MemoryResource* getResource() const noexcept
+    {
+        return resource;
+    }
+
+private:
+    MemoryResource* resource;
+};
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T>& left, const ResourceAllocator<U>& right) noexcept
+{
+    return left.getResource() == right.getResource() || left.getResource()->isEqual(*right.getResource());
+}
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T>& left, const ResourceAllocator<U>& right) noexcept
+{
+    return !(left == right);
+}
+
+#endif // EQUEUM_FUNCTION_PARSER_MEMORY_RESOURCE_H_INCLUDED
@@ -0,0 +1,82 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ParseError.h"
+
+#include <string>
+
+namespace
+{
+
+std::string makeParseErrorMessage(const ParseError& error)
+{
+    return std::string("Parse error at offset ") + std::to_string(error.offset)
+            + ": " + getParseErrorDescription(error.code);
+}
+
+} // namespace
+
+const char* getParseErrorDescription(ParseErrorCode code)
+{
+    switch (code)
+    {
+        case PARSE_ERROR_NONE:
+            return "no error";
+        case PARSE_ERROR_UNEXPECTED_CHARACTER:
+            return "unexpected character";
+        case PARSE_ERROR_INVALID_NAME:
+            return "invalid name";
+        case PARSE_ERROR_INVALID_NUMBER:
+            return "invalid number";
+        case PARSE_ERROR_EXPECTED_FUNCTION_NAME:
+            return "expected function name";
+        case PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS:
+            return "expected '('";
+        case PARSE_ERROR_EXPECTED_PARAMETER_NAME:
+            return "expected parameter name";
+        case PARSE_ERROR_EXPECTED_ASSIGNMENT:
+            return "expected '='";
+        case PARSE_ERROR_EXPECTED_VALUE:
+            return "expected number or string literal";
+        case PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS:
+            return "expected ',' or ')'";
+        case PARSE_ERROR_POSITIONAL_AFTER_NAMED:
+            return "positional parameter after named one";
+        case PARSE_ERROR_TRAILING_INPUT:
+            return "unexpected input after ')'";
+        case PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS:
+            return "expected ')'";
+        case PARSE_ERROR_NESTING_TOO_DEEP:
+            return "expression is nested too deep";
+        case PARSE_ERROR_UNTERMINATED_STRING:
+            return "unterminated string literal";
+        case PARSE_ERROR_INPUT_TOO_LONG:
+            return "input is too long";
+        case PARSE_ERROR_TOO_MANY_LEXEMES:
+            return "too many lexemes";
+        case PARSE_ERROR_LITERAL_TOO_LONG:
+            return "literal is too long";
+        case PARSE_ERROR_UNKNOWN_FUNCTION:
+            return "unknown function";
+        case PARSE_ERROR_UNKNOWN_PARAMETER:
+            return "unknown parameter";
+        case PARSE_ERROR_DUPLICATE_PARAMETER:
+            return "duplicate parameter";
+        case PARSE_ERROR_TOO_MANY_PARAMETERS:
+            return "too many parameters";
+        case PARSE_ERROR_MISSING_PARAMETER:
+            return "missing parameter";
+        case PARSE_ERROR_INVALID_ARGUMENT_TYPE:
+            return "value can't be converted to parameter type";
+        case PARSE_ERROR_INVALID_ENCODING:
+            return "invalid binary encoding";
+    }
+    return "unknown error";
+}
+
+ParseException::ParseException(const ParseError& error)
+    : std::runtime_error(makeParseErrorMessage(error)),
+      error(error)
+{}
@@ -0,0 +1,108 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_PARSE_ERROR_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_PARSE_ERROR_H_INCLUDED
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+enum ParseErrorCode : int
+{
+    PARSE_ERROR_NONE,
+    PARSE_ERROR_UNEXPECTED_CHARACTER, // character that can't start any lexeme, like stray '.'
+    PARSE_ERROR_INVALID_NAME, // name with unexpected characters, like "abc.def"
+    PARSE_ERROR_INVALID_NUMBER, // malformed number, like "1.2.3", "1." or "123abc"
+    PARSE_ERROR_EXPECTED_FUNCTION_NAME,
+    PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS,
+    PARSE_ERROR_EXPECTED_PARAMETER_NAME,
+    PARSE_ERROR_EXPECTED_ASSIGNMENT, // '=' after parameter name
+    PARSE_ERROR_EXPECTED_VALUE, // number or string literal
+    PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS,
+    PARSE_ERROR_POSITIONAL_AFTER_NAMED, // positional parameter after named one
+    PARSE_ERROR_TRAILING_INPUT, // anything but whitespace after closing parenthesis
+    PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS, // closing parenthesis of parenthesized expression
+    PARSE_ERROR_NESTING_TOO_DEEP, // too many nested calls or parentheses
+    PARSE_ERROR_UNTERMINATED_STRING, // string literal without closing quotation mark
+    PARSE_ERROR_INPUT_TOO_LONG, // see ParseLimits
+    PARSE_ERROR_TOO_MANY_LEXEMES, // see ParseLimits
+    PARSE_ERROR_LITERAL_TOO_LONG, // see ParseLimits
+
+    // Binding call to the spec
+    PARSE_ERROR_UNKNOWN_FUNCTION,
+    PARSE_ERROR_UNKNOWN_PARAMETER,
+    PARSE_ERROR_DUPLICATE_PARAMETER,
+    PARSE_ERROR_TOO_MANY_PARAMETERS,
+    PARSE_ERROR_MISSING_PARAMETER, // parameter without default value is not given
+    PARSE_ERROR_INVALID_ARGUMENT_TYPE, // value can't be converted to parameter type
+
+    // Reading binary encoded call
+    PARSE_ERROR_INVALID_ENCODING, // truncated or malformed data
+};
+
+struct ParseError
+{
+    ParseErrorCode code;
+    size_t offset; // byte offset in the input where error was detected.
+};
+
+const char* getParseErrorDescription(ParseErrorCode code);
+
+/// Either parsed value or an error, never throws on its own.
+template <typename T>
+class ParseResult
+{
+public:
+    ParseResult(T value)
+        : value(std::move(value)),
+          error{PARSE_ERROR_NONE, 0}
+    {}
+
+    ParseResult(const ParseError& error)
+        : value(),
+          error(error)
+    {}
+
+    explicit operator bool() const
+    {
+        return error.code == PARSE_ERROR_NONE;
+    }
+
+    const T& getValue() const
+    {
+        return value;
+    }
+
+    T& getValue()
+    {
+        return value;
+    }
+
+    const ParseError& getError() const
+    {
+        return error;
+    }
+
+private:
+    T value;
+    ParseError error;
+};
+
+class ParseException : public std::runtime_error
+{
+public:
+    explicit ParseException(const ParseError& error);
+
+    const ParseError& getError() const
+    {
+        return error;
+    }
+
+private:
+    ParseError error;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_PARSE_ERROR_H_INCLUDED
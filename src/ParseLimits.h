@@ -0,0 +1,22 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_PARSE_LIMITS_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_PARSE_LIMITS_H_INCLUDED
+
+#include <cstddef>
+
+/// Hard limits on untrusted input, checked by the Lexer before the input is parsed further.
+/// Parsing is linear in the input size, limits bound that size and the memory of the result.
+struct ParseLimits
+{
+    size_t maxInputLength; // bytes, longer input is rejected without being read.
+    size_t maxLexemeCount;
+    size_t maxLiteralLength; // bytes of a string or number literal, including quotes.
+};
+
+const ParseLimits DefaultParseLimits = {1024 * 1024, 64 * 1024, 64 * 1024};
+
+#endif // EQUEUM_FUNCTION_PARSER_PARSE_LIMITS_H_INCLUDED
@@ -0,0 +1,135 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ParsedCallCache.h"
+
+#include "Hash.h"
+
+namespace
+{
+
+size_t estimateMemoryUsage(boost::string_view input, const FunctionCall& call)
+{
+    // list node, index node and shared_ptr control block, roughly.
+    const size_t EntryOverhead = 128;
+
+    size_t result = EntryOverhead + sizeof(FunctionCall) + input.size() + call.name.capacity()
+            + (call.parameters.isInline() ? 0 : call.parameters.capacity() * sizeof(FunctionCallParameter));
+    for (const auto& param : call.parameters)
+    {
+        result += param.value.capacity() + (param.name ? param.name->capacity() : 0);
+    }
+
+    return result;
+}
+
+} // namespace
+
+size_t ParsedCallCache::InputHash::operator()(boost::string_view input) const
+{
+    return static_cast<size_t>(hashBytes(input));
+}
+
+ParsedCallCache::ParsedCallCache(size_t memoryLimit)
+    : memoryLimit(memoryLimit),
+      memoryUsage(0),
+      hits(0),
+      misses(0)
+{}
+
+ParsedCallCache::~ParsedCallCache()
+{}
+
+ParseResult<ParsedCallCache::FunctionCallPtr> ParsedCallCache::parse(boost::string_view input)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto p = index.find(input);
+        if (p != index.end())
+        {
+            ++hits;
+            entries.splice(entries.begin(), entries, p->second);
+
+            return p->second->call;
+        }
+        ++misses;
+    }
+
+    ParseResult<FunctionCall> result = tryParseFunctionCall(input);
+    if (!result)
+    {
+        return result.getError();
+    }
+
+    const FunctionCallPtr call = std::make_shared<const FunctionCall>(std::move(result.getValue()));
+    insert(input, call);
+
+    return call;
+}
+
+void ParsedCallCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    entries.clear();
+    memoryUsage = 0;
+}
+
+size_t ParsedCallCache::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t ParsedCallCache::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t ParsedCallCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t ParsedCallCache::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryUsage;
+}
+
+void ParsedCallCache::insert(boost::string_view input, const FunctionCallPtr& call)
+{
+    const size_t entryMemoryUsage = estimateMemoryUsage(input, *call);
+    if (entryMemoryUsage > memoryLimit)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(input) != 0)
+    {
+        // Parsed and inserted concurrently by another thread.
+        return;
+    }
+
+    entries.push_front(Entry{input.to_string(), call, entryMemoryUsage});
+    index.emplace(boost::string_view(entries.front().input), entries.begin());
+    memoryUsage += entryMemoryUsage;
+
+    evict();
+}
+
+void ParsedCallCache::evict()
+{
+    while (memoryUsage > memoryLimit && !entries.empty())
+    {
+        const Entry& entry = entries.back();
+        index.erase(boost::string_view(entry.input));
+        memoryUsage -= entry.memoryUsage;
+        entries.pop_back();
+    }
+}
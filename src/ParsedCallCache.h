@@ -0,0 +1,72 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_PARSED_CALL_CACHE_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_PARSED_CALL_CACHE_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// LRU cache in front of tryParseFunctionCall, keyed by exact input text.
+/// Only successfully parsed calls are cached. Memory used by cached inputs and calls
+/// is kept under the limit by evicting least recently used entries.
+/// Thread-safe, parsing on miss is done without holding the lock.
+class ParsedCallCache
+{
+public:
+    typedef std::shared_ptr<const FunctionCall> FunctionCallPtr;
+
+    /// memoryLimit is approximate, in bytes.
+    explicit ParsedCallCache(size_t memoryLimit);
+    ~ParsedCallCache();
+
+    ParseResult<FunctionCallPtr> parse(boost::string_view input);
+
+    void clear();
+
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getSize() const;
+    size_t getMemoryUsage() const;
+
+private:
+    struct Entry
+    {
+        std::string input;
+        FunctionCallPtr call;
+        size_t memoryUsage;
+    };
+    typedef std::list<Entry> EntryList;
+
+    struct InputHash
+    {
+        size_t operator()(boost::string_view input) const;
+    };
+
+    void insert(boost::string_view input, const FunctionCallPtr& call);
+    void evict();
+
+private:
+    const size_t memoryLimit;
+
+    // Most recently used first.
+    EntryList entries;
+    // Keys point to Entry::input.
+    std::unordered_map<boost::string_view, EntryList::iterator, InputHash> index;
+
+    mutable std::mutex mutex;
+    size_t memoryUsage;
+    size_t hits;
+    size_t misses;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_PARSED_CALL_CACHE_H_INCLUDED
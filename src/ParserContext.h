@@ -0,0 +1,55 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_PARSER_CONTEXT_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_PARSER_CONTEXT_H_INCLUDED
+
+#include "Expression.h"
+#include "FunctionParser.h"
+#include "ParseError.h"
+#include "ParseLimits.h"
+#include "StringView.h"
+#include "SymbolTable.h"
+
+/// Scratch state of the parser, kept across inputs. Parsing into the same FunctionCall
+/// or FunctionSpec over and over reuses their parameters and strings, so once capacities
+/// settle it doesn't allocate. Not thread-safe, keep one per thread:
+///
+///     ParserContext context;
+///     FunctionCall call;
+///     for (const auto& line : lines)
+///     {
+///         context.reset(line);
+///         const ParseError error = context.parseCall(call);
+///         ...
+///     }
+class ParserContext
+{
+public:
+    /// Same as for tryParseFunctionCall, symbols must outlive the context.
+    /// Inputs exceeding limits are rejected early, as those of tryParseFunctionCall with DefaultParseLimits.
+    explicit ParserContext(const SymbolTable* symbols = nullptr, const ParseLimits& limits = DefaultParseLimits);
+    ~ParserContext();
+
+    /// Sets input of the next parse, it must outlive the parse. Keeps allocated memory.
+    void reset(boost::string_view input);
+
+    /// Same grammar and errors as tryParseFunctionCall and tryParseFunctionSpec,
+    /// result is unspecified on error.
+    ParseError parseCall(FunctionCall& result);
+    ParseError parseSpec(FunctionSpec& result);
+    /// Into a new call, for results that are kept, only scratch state is reused.
+    ParseResult<FunctionCall> parseCall();
+
+private:
+    boost::string_view input;
+    const SymbolTable* symbols;
+    const ParseLimits limits;
+    ExpressionTree expressionTree;
+    // Parameters dropped from calls, when the next call has fewer of them than the previous one.
+    FunctionCallParameters spareParameters;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_PARSER_CONTEXT_H_INCLUDED
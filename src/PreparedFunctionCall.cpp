@@ -0,0 +1,161 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "PreparedFunctionCall.h"
+
+#include "FunctionCallVisitor.h"
+
+#include <stdexcept>
+
+/// Puts template arguments into spec positions.
+class PreparedFunctionCallBuilder : public FunctionCallVisitor
+{
+public:
+    PreparedFunctionCallBuilder(const FunctionRegistry& registry, PreparedFunctionCall& result)
+        : registry(registry),
+          result(result),
+          spec(nullptr),
+          argumentCount(0)
+    {}
+
+    ParseErrorCode visitFunctionName(const Lexeme& name) override
+    {
+        spec = registry.findFunctionSpecByName(name.value);
+        if (!spec)
+        {
+            return PARSE_ERROR_UNKNOWN_FUNCTION;
+        }
+
+        result.call.name = spec->name.to_string();
+        result.call.nameId = spec->nameId;
+        isSet.assign(spec->parameters.size(), false);
+        result.call.parameters.clear();
+        for (const auto& parameter : spec->parameters)
+        {
+            result.call.parameters.push_back(FunctionCallParameter{parameter.name.to_string(), std::string(),
+                    CALL_VALUE_NUMBER, parameter.nameId});
+        }
+
+        return PARSE_ERROR_NONE;
+    }
+
+    ParseErrorCode visitParameter(const Lexeme* name, const Lexeme& value) override
+    {
+        size_t position = argumentCount++;
+        if (name)
+        {
+            for (position = 0; position < spec->parameters.size() && spec->parameters[position].name != name->value;
+                    ++position)
+            {}
+            if (position == spec->parameters.size())
+            {
+                return PARSE_ERROR_UNKNOWN_PARAMETER;
+            }
+        }
+        else if (position >= spec->parameters.size())
+        {
+            return PARSE_ERROR_TOO_MANY_PARAMETERS;
+        }
+
+        if (isSet[position])
+        {
+            return PARSE_ERROR_DUPLICATE_PARAMETER;
+        }
+        isSet[position] = true;
+
+        if (value.type == LEX_PLACEHOLDER)
+        {
+            result.placeholderPositions.push_back(position);
+        }
+        else
+        {
+            FunctionCallParameter& parameter = result.call.parameters[position];
+            parameter.value = value.value.to_string();
+            parameter.valueType = getCallValueType(value);
+        }
+
+        return PARSE_ERROR_NONE;
+    }
+
+    /// Fills omitted parameters with defaults, returns false if some has no default.
+    bool applyDefaults()
+    {
+        for (size_t i = 0; i < spec->parameters.size(); ++i)
+        {
+            if (isSet[i])
+            {
+                continue;
+            }
+            if (!spec->parameters[i].value)
+            {
+                return false;
+            }
+            result.call.parameters[i].value = spec->parameters[i].value->to_string();
+            result.call.parameters[i].valueType = getLiteralValueType(*spec->parameters[i].value);
+        }
+
+        return true;
+    }
+
+private:
+    const FunctionRegistry& registry;
+    PreparedFunctionCall& result;
+    const RegisteredFunctionSpec* spec;
+    size_t argumentCount;
+    std::vector<bool> isSet;
+};
+
+PreparedFunctionCall::PreparedFunctionCall()
+{}
+
+PreparedFunctionCall::~PreparedFunctionCall()
+{}
+
+FunctionCall PreparedFunctionCall::bind(const std::vector<std::string>& values) const
+{
+    FunctionCall result;
+    bind(values.data(), values.size(), result);
+
+    return result;
+}
+
+void PreparedFunctionCall::bind(const std::string* values, size_t valueCount, FunctionCall& result) const
+{
+    if (valueCount != placeholderPositions.size())
+    {
+        throw std::invalid_argument("Expected " + std::to_string(placeholderPositions.size())
+                + " values for placeholders of \"" + call.name + "\", got " + std::to_string(valueCount));
+    }
+
+    // Assignment reuses memory of the strings already in result.
+    result.name = call.name;
+    result.nameId = call.nameId;
+    result.parameters = call.parameters;
+    for (size_t i = 0; i < valueCount; ++i)
+    {
+        FunctionCallParameter& parameter = result.parameters[placeholderPositions[i]];
+        parameter.value = values[i];
+        parameter.valueType = getLiteralValueType(values[i]);
+    }
+}
+
+ParseResult<PreparedFunctionCall> prepareFunctionCall(boost::string_view callTemplate,
+        const FunctionRegistry& registry)
+{
+    PreparedFunctionCall result;
+    PreparedFunctionCallBuilder builder(registry, result);
+
+    const ParseError error = visitFunctionCallTemplate(callTemplate, builder);
+    if (error.code != PARSE_ERROR_NONE)
+    {
+        return error;
+    }
+    if (!builder.applyDefaults())
+    {
+        return ParseError{PARSE_ERROR_MISSING_PARAMETER, callTemplate.size()};
+    }
+
+    return result;
+}
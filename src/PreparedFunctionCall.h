@@ -0,0 +1,61 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_PREPARED_FUNCTION_CALL_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_PREPARED_FUNCTION_CALL_H_INCLUDED
+
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+#include "ParseError.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// Call template with '?' placeholders, resolved against the FunctionRegistry once,
+/// like a prepared statement:
+///
+///     auto prepared = prepareFunctionCall("f(a=?, b=?, c=\"fixed\")", registry);
+///     FunctionCall call = prepared.getValue().bind({"1", "\"foo\""});
+///
+/// Bound calls are what updateFunctionCall() gives for the same text: every parameter is named
+/// and has nameId, omitted ones have default values. Parameters are in spec order.
+/// Binding does no tokenizing or lexing: values are stored as given, so they must be
+/// literals as written in a call, see writeStringLiteral() for strings. Their valueType is
+/// told by getLiteralValueType().
+class PreparedFunctionCall
+{
+public:
+    PreparedFunctionCall();
+    ~PreparedFunctionCall();
+
+    /// Number of values bind() expects.
+    size_t getPlaceholderCount() const
+    {
+        return placeholderPositions.size();
+    }
+
+    /// Values replace placeholders in the order they appear in the template.
+    /// Throw std::invalid_argument if number of values doesn't match getPlaceholderCount().
+    FunctionCall bind(const std::vector<std::string>& values) const;
+    /// Reuses memory of the result, so binding into the same call over and over doesn't allocate.
+    void bind(const std::string* values, size_t valueCount, FunctionCall& result) const;
+
+private:
+    friend class PreparedFunctionCallBuilder;
+
+    // Values of placeholder parameters are empty.
+    FunctionCall call;
+    // Position in call.parameters of each placeholder.
+    std::vector<size_t> placeholderPositions;
+};
+
+/// Reports unknown function or parameter, duplicate, extra or missing parameters.
+/// Placeholders are allowed only as whole arguments, not inside expressions.
+ParseResult<PreparedFunctionCall> prepareFunctionCall(boost::string_view callTemplate,
+        const FunctionRegistry& registry);
+
+#endif // EQUEUM_FUNCTION_PARSER_PREPARED_FUNCTION_CALL_H_INCLUDED
@@ -0,0 +1,148 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_RESULT_CACHE_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_RESULT_CACHE_H_INCLUDED
+
+#include "Hash.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+struct ResultCacheStatistics
+{
+    uint64_t hits;
+    uint64_t misses;
+    size_t size;
+};
+
+/// Appends canonical binary form of the argument to the cache key.
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type appendResultCacheKey(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// Length-prefixed, so that ("ab", "c") and ("a", "bc") are different keys.
+inline void appendResultCacheKey(std::string& key, boost::string_view value)
+{
+    const uint64_t size = value.size();
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(value.data(), value.size());
+}
+
+inline void appendResultCacheKey(std::string& key, const std::string& value)
+{
+    appendResultCacheKey(key, boost::string_view(value));
+}
+
+template <typename Tuple, size_t... I>
+void appendResultCacheKeys(std::string& key, const Tuple& values, std::index_sequence<I...>)
+{
+    const int unused[] = {0, (appendResultCacheKey(key, std::get<I>(values)), 0)...};
+    static_cast<void>(unused);
+}
+
+/// Builds cache key from the tuple of arguments, reusing key's memory.
+template <typename... Args>
+void makeResultCacheKey(std::string& key, const std::tuple<Args...>& arguments)
+{
+    key.clear();
+    appendResultCacheKeys(key, arguments, std::index_sequence_for<Args...>());
+}
+
+/// LRU cache of results of a single pure function, keyed by canonical form
+/// of the arguments, see makeResultCacheKey. Thread-safe.
+template <typename Result>
+class ResultCache
+{
+public:
+    explicit ResultCache(size_t maxSize)
+        : maxSize(maxSize),
+          hits(0),
+          misses(0)
+    {}
+
+    /// Returns false and counts a miss if there is no such key.
+    bool find(boost::string_view key, Result& result)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto p = index.find(key);
+        if (p == index.end())
+        {
+            ++misses;
+            return false;
+        }
+
+        ++hits;
+        entries.splice(entries.begin(), entries, p->second);
+        result = p->second->second;
+
+        return true;
+    }
+
+    void insert(boost::string_view key, const Result& result)
+    {
+        if (maxSize == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index.count(key) != 0)
+        {
+            // Computed and inserted concurrently by another thread.
+            return;
+        }
+
+        entries.emplace_front(key.to_string(), result);
+        index.emplace(boost::string_view(entries.front().first), entries.begin());
+
+        if (entries.size() > maxSize)
+        {
+            index.erase(boost::string_view(entries.back().first));
+            entries.pop_back();
+        }
+    }
+
+    ResultCacheStatistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ResultCacheStatistics{hits, misses, entries.size()};
+    }
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(boost::string_view key) const
+        {
+            return static_cast<size_t>(hashBytes(key));
+        }
+    };
+
+    // Most recently used first.
+    typedef std::list<std::pair<std::string, Result>> EntryList;
+
+private:
+    const size_t maxSize;
+
+    EntryList entries;
+    // Keys point to EntryList keys.
+    std::unordered_map<boost::string_view, typename EntryList::iterator, KeyHash> index;
+
+    mutable std::mutex mutex;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_RESULT_CACHE_H_INCLUDED
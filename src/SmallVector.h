@@ -0,0 +1,732 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_SMALL_VECTOR_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_SMALL_VECTOR_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Vector that keeps up to InlineCapacity elements inside the object and moves them
+/// to the heap only when more are added. Most of std::vector API, without max_size(),
+/// shrink_to_fit() and ordering comparisons; iterators are pointers.
+/// Like std::vector, copy assignment reuses existing elements, so assigning calls of
+/// the same shape over and over doesn't allocate. Heap memory comes from Allocator,
+/// which is propagated according to its allocator_traits.
+template <typename T, size_t InlineCapacity, typename Allocator = std::allocator<T>>
+class SmallVector : private Allocator
+{
+    static_assert(InlineCapacity > 0, "InlineCapacity must be positive.");
+
+    typedef std::allocator_traits<Allocator> AllocatorTraits;
+
+    /// Keeps (count, value) overloads from being taken for iterator ranges.
+    template <typename Iterator>
+    using EnableIfIterator = typename std::enable_if<!std::is_integral<Iterator>::value>::type;
+
+public:
+    typedef Allocator allocator_type;
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    SmallVector() noexcept(noexcept(Allocator()))
+        : SmallVector(Allocator())
+    {}
+
+    explicit SmallVector(const Allocator& allocator) noexcept
+        : Allocator(allocator),
+          elements(getInlineElements()),
+          count(0),
+          capacityValue(InlineCapacity)
+    {}
+
+    SmallVector(std::initializer_list<T> values, const Allocator& allocator = Allocator())
+        : SmallVector(allocator)
+    {
+        reserve(values.size());
+        for (const auto& value : values)
+        {
+            new (elements + count) T(value);
+            ++count;
+        }
+    }
+
+    SmallVector(size_t newSize, const T& value, const Allocator& allocator = Allocator())
+        : SmallVector(allocator)
+    {
+        resize(newSize, value);
+    }
+
+    template <typename InputIterator, typename = EnableIfIterator<InputIterator>>
+    SmallVector(InputIterator first, InputIterator last, const Allocator& allocator = Allocator())
+        : SmallVector(allocator)
+    {
+        append(first, last);
+    }
+
+    SmallVector(const SmallVector& other)
+        : SmallVector(AllocatorTraits::select_on_container_copy_construction(other.getAllocator()))
+    {
+        reserve(other.count);
+        for (const auto& value : other)
+        {
+            new (elements + count) T(value);
+            ++count;
+        }
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : SmallVector(other.getAllocator())
+    {
+        moveFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        destroy(elements, elements + count);
+        deallocate();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        propagateAllocator(other.getAllocator(),
+                typename AllocatorTraits::propagate_on_container_copy_assignment());
+        if (other.count > capacityValue)
+        {
+            clear();
+            reserve(other.count);
+        }
+
+        const size_t assignedCount = std::min(count, other.count);
+        std::copy(other.elements, other.elements + assignedCount, elements);
+        for (; count < other.count; ++count)
+        {
+            new (elements + count) T(other.elements[count]);
+        }
+        destroy(elements + other.count, elements + count);
+        count = other.count;
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(
+            AllocatorTraits::propagate_on_container_move_assignment::value
+            && std::is_nothrow_move_constructible<T>::value
+            && std::is_nothrow_move_assignable<T>::value)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        propagateAllocator(other.getAllocator(),
+                typename AllocatorTraits::propagate_on_container_move_assignment());
+        if (!other.isInline() && getAllocator() == other.getAllocator())
+        {
+            // Steal the heap buffer.
+            destroy(elements, elements + count);
+            deallocate();
+            elements = other.elements;
+            count = other.count;
+            capacityValue = other.capacityValue;
+            other.resetToInline();
+            return *this;
+        }
+
+        // Memory of other can't be taken, move elements one by one.
+        if (other.count > capacityValue)
+        {
+            clear();
+            reserve(other.count);
+        }
+
+        const size_t assignedCount = std::min(count, other.count);
+        std::move(other.elements, other.elements + assignedCount, elements);
+        for (; count < other.count; ++count)
+        {
+            new (elements + count) T(std::move(other.elements[count]));
+        }
+        destroy(elements + other.count, elements + count);
+        count = other.count;
+        other.clear();
+
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> values)
+    {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    Allocator get_allocator() const noexcept
+    {
+        return getAllocator();
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacityValue;
+    }
+
+    /// True if elements are inside the object.
+    bool isInline() const noexcept
+    {
+        return elements == getInlineElements();
+    }
+
+    T* data() noexcept
+    {
+        return elements;
+    }
+
+    const T* data() const noexcept
+    {
+        return elements;
+    }
+
+    iterator begin() noexcept
+    {
+        return elements;
+    }
+
+    iterator end() noexcept
+    {
+        return elements + count;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return elements;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return elements + count;
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return elements;
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return elements + count;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    T& operator[](size_t index)
+    {
+        return elements[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return elements[index];
+    }
+
+    T& at(size_t index)
+    {
+        checkIndex(index);
+        return elements[index];
+    }
+
+    const T& at(size_t index) const
+    {
+        checkIndex(index);
+        return elements[index];
+    }
+
+    T& front()
+    {
+        return elements[0];
+    }
+
+    const T& front() const
+    {
+        return elements[0];
+    }
+
+    T& back()
+    {
+        return elements[count - 1];
+    }
+
+    const T& back() const
+    {
+        return elements[count - 1];
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (count < capacityValue)
+        {
+            new (elements + count) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            // Arguments may refer to elements, construct the new one before moving them.
+            const size_t newCapacity = capacityValue * 2;
+            T* newElements = allocate(newCapacity);
+            try
+            {
+                new (newElements + count) T(std::forward<Args>(args)...);
+                try
+                {
+                    moveElementsTo(newElements);
+                }
+                catch (...)
+                {
+                    newElements[count].~T();
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                AllocatorTraits::deallocate(getAllocator(), newElements, newCapacity);
+                throw;
+            }
+            adoptBuffer(newElements, newCapacity);
+        }
+
+        return elements[count++];
+    }
+
+    void pop_back()
+    {
+        --count;
+        elements[count].~T();
+    }
+
+    void clear() noexcept
+    {
+        destroy(elements, elements + count);
+        count = 0;
+    }
+
+    void reserve(size_t newCapacity)
+    {
+        if (newCapacity > capacityValue)
+        {
+            T* newElements = allocate(newCapacity);
+            try
+            {
+                moveElementsTo(newElements);
+            }
+            catch (...)
+            {
+                AllocatorTraits::deallocate(getAllocator(), newElements, newCapacity);
+                throw;
+            }
+            adoptBuffer(newElements, newCapacity);
+        }
+    }
+
+    void resize(size_t newSize)
+    {
+        reserve(newSize);
+        for (; count < newSize; ++count)
+        {
+            new (elements + count) T();
+        }
+        destroy(elements + newSize, elements + count);
+        count = std::min(count, newSize);
+    }
+
+    void resize(size_t newSize, const T& value)
+    {
+        if (newSize > capacityValue)
+        {
+            // value may be an element.
+            const T copy(value);
+            reserve(newSize);
+            resize(newSize, copy);
+            return;
+        }
+
+        for (; count < newSize; ++count)
+        {
+            new (elements + count) T(value);
+        }
+        destroy(elements + newSize, elements + count);
+        count = std::min(count, newSize);
+    }
+
+    void assign(size_t newSize, const T& value)
+    {
+        if (newSize > capacityValue)
+        {
+            // value may be an element.
+            const T copy(value);
+            clear();
+            resize(newSize, copy);
+            return;
+        }
+
+        std::fill_n(elements, std::min(count, newSize), value);
+        resize(newSize, value);
+    }
+
+    /// Like copy assignment, reuses existing elements. Iterators must not point into the vector.
+    template <typename InputIterator, typename = EnableIfIterator<InputIterator>>
+    void assign(InputIterator first, InputIterator last)
+    {
+        size_t assignedCount = 0;
+        for (; assignedCount < count && first != last; ++assignedCount, ++first)
+        {
+            elements[assignedCount] = *first;
+        }
+        destroy(elements + assignedCount, elements + count);
+        count = assignedCount;
+        append(first, last);
+    }
+
+    void assign(std::initializer_list<T> values)
+    {
+        assign(values.begin(), values.end());
+    }
+
+    iterator insert(const_iterator position, const T& value)
+    {
+        return emplace(position, value);
+    }
+
+    iterator insert(const_iterator position, T&& value)
+    {
+        return emplace(position, std::move(value));
+    }
+
+    iterator insert(const_iterator position, size_t insertedCount, const T& value)
+    {
+        const size_t index = position - elements;
+        // value may be an element.
+        const T copy(value);
+        growFor(count + insertedCount);
+        resize(count + insertedCount, copy);
+        return rotateTail(index, count - insertedCount);
+    }
+
+    /// Iterators must not point into the vector.
+    template <typename InputIterator, typename = EnableIfIterator<InputIterator>>
+    iterator insert(const_iterator position, InputIterator first, InputIterator last)
+    {
+        const size_t index = position - elements;
+        const size_t oldCount = count;
+        append(first, last);
+        return rotateTail(index, oldCount);
+    }
+
+    iterator insert(const_iterator position, std::initializer_list<T> values)
+    {
+        return insert(position, values.begin(), values.end());
+    }
+
+    /// Constructs the element at the end and rotates it into place.
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args&&... args)
+    {
+        const size_t index = position - elements;
+        emplace_back(std::forward<Args>(args)...);
+        return rotateTail(index, count - 1);
+    }
+
+    iterator erase(const_iterator position)
+    {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* const firstElement = elements + (first - elements);
+        if (first != last)
+        {
+            T* const newEnd = std::move(elements + (last - elements), elements + count, firstElement);
+            destroy(newEnd, elements + count);
+            count = newEnd - elements;
+        }
+        return firstElement;
+    }
+
+    /// Exchanges buffers when both are on the heap with equal allocators, moves elements
+    /// otherwise. Allocators are never swapped, same as they are never propagated on move.
+    void swap(SmallVector& other)
+    {
+        if (this == &other)
+        {
+            return;
+        }
+
+        SmallVector temporary(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temporary);
+    }
+
+    friend void swap(SmallVector& left, SmallVector& right)
+    {
+        left.swap(right);
+    }
+
+    std::vector<T> toVector() const
+    {
+        return std::vector<T>(begin(), end());
+    }
+
+    friend bool operator==(const SmallVector& left, const SmallVector& right)
+    {
+        return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+    }
+
+    friend bool operator!=(const SmallVector& left, const SmallVector& right)
+    {
+        return !(left == right);
+    }
+
+private:
+    T* getInlineElements() noexcept
+    {
+        return reinterpret_cast<T*>(&inlineStorage);
+    }
+
+    const T* getInlineElements() const noexcept
+    {
+        return reinterpret_cast<const T*>(&inlineStorage);
+    }
+
+    Allocator& getAllocator() noexcept
+    {
+        return *this;
+    }
+
+    const Allocator& getAllocator() const noexcept
+    {
+        return *this;
+    }
+
+    T* allocate(size_t capacity)
+    {
+        return AllocatorTraits::allocate(getAllocator(), capacity);
+    }
+
+    void deallocate() noexcept
+    {
+        if (!isInline())
+        {
+            AllocatorTraits::deallocate(getAllocator(), elements, capacityValue);
+        }
+    }
+
+    /// Takes allocator of the other vector, dropping memory allocated by the current one.
+    void propagateAllocator(const Allocator& allocator, std::true_type)
+    {
+        if (getAllocator() != allocator)
+        {
+            clear();
+            deallocate();
+            resetToInline();
+        }
+        getAllocator() = allocator;
+    }
+
+    void propagateAllocator(const Allocator& /*allocator*/, std::false_type) noexcept
+    {}
+
+    static void destroy(T* first, T* last) noexcept
+    {
+        for (; first < last; ++first)
+        {
+            first->~T();
+        }
+    }
+
+    /// Constructs elements in uninitialized buffer, elements are left intact if that throws.
+    void moveElementsTo(T* newElements)
+    {
+        size_t moved = 0;
+        try
+        {
+            for (; moved < count; ++moved)
+            {
+                new (newElements + moved) T(std::move_if_noexcept(elements[moved]));
+            }
+        }
+        catch (...)
+        {
+            destroy(newElements, newElements + moved);
+            throw;
+        }
+    }
+
+    /// Switches to the buffer with elements moved by moveElementsTo().
+    void adoptBuffer(T* newElements, size_t newCapacity) noexcept
+    {
+        destroy(elements, elements + count);
+        deallocate();
+        elements = newElements;
+        capacityValue = newCapacity;
+    }
+
+    void moveFrom(SmallVector& other)
+    {
+        if (!other.isInline())
+        {
+            elements = other.elements;
+            count = other.count;
+            capacityValue = other.capacityValue;
+            other.resetToInline();
+            return;
+        }
+
+        for (; count < other.count; ++count)
+        {
+            new (elements + count) T(std::move(other.elements[count]));
+        }
+        other.clear();
+    }
+
+    template <typename InputIterator>
+    void reserveForRange(InputIterator /*first*/, InputIterator /*last*/, std::input_iterator_tag)
+    {}
+
+    template <typename ForwardIterator>
+    void reserveForRange(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+    {
+        growFor(count + std::distance(first, last));
+    }
+
+    /// Reserves geometrically, so that repeated insertions take amortized constant time.
+    void growFor(size_t newCount)
+    {
+        if (newCount > capacityValue)
+        {
+            reserve(std::max(newCount, capacityValue * 2));
+        }
+    }
+
+    /// Appends the range, the vector is left as before if that throws.
+    template <typename InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+        reserveForRange(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+        const size_t oldCount = count;
+        try
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+        catch (...)
+        {
+            destroy(elements + oldCount, elements + count);
+            count = oldCount;
+            throw;
+        }
+    }
+
+    /// Moves elements appended after oldCount to index, returns iterator to the first of them.
+    iterator rotateTail(size_t index, size_t oldCount)
+    {
+        std::rotate(elements + index, elements + oldCount, elements + count);
+        return elements + index;
+    }
+
+    void resetToInline() noexcept
+    {
+        elements = getInlineElements();
+        count = 0;
+        capacityValue = InlineCapacity;
+    }
+
+    void checkIndex(size_t index) const
+    {
+        if (index >= count)
+        {
+            throw std::out_of_range("SmallVector index " + std::to_string(index)
+                    + " is out of range, size is " + std::to_string(count));
+        }
+    }
+
+private:
+    T* elements;
+    size_t count;
+    size_t capacityValue;
+    typename std::aligned_storage<sizeof(T) * InlineCapacity, alignof(T)>::type inlineStorage;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_SMALL_VECTOR_H_INCLUDED
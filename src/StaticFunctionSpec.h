@@ -0,0 +1,320 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_STATIC_FUNCTION_SPEC_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_STATIC_FUNCTION_SPEC_H_INCLUDED
+
+#include "FunctionParser.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/// Compile-time counterpart of FunctionSpec, parsed from a string literal by
+/// STATIC_FUNCTION_SPEC. Malformed spec is a compile error, grammar is the same
+/// as for parseFunctionSpec.
+///
+///     constexpr auto spec = STATIC_FUNCTION_SPEC("f(a, b=24)");
+///     static_assert(spec.parameterCount == 2, "");
+///     registry.addFunction(spec);
+
+struct StaticStringRef
+{
+    constexpr StaticStringRef()
+        : data(""),
+          size(0)
+    {}
+
+    constexpr StaticStringRef(const char* data, size_t size)
+        : data(data),
+          size(size)
+    {}
+
+    constexpr bool operator==(const StaticStringRef& other) const
+    {
+        if (size != other.size)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] != other.data[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string toString() const
+    {
+        return std::string(data, size);
+    }
+
+    const char* data;
+    size_t size;
+};
+
+struct StaticFunctionSpecParameter
+{
+    constexpr StaticFunctionSpecParameter()
+        : name(),
+          value(),
+          hasValue(false)
+    {}
+
+    StaticStringRef name;
+    StaticStringRef value; // default value, set only if hasValue.
+    bool hasValue;
+};
+
+/// MaxParameters is capacity, parameterCount is the actual number of parameters.
+template <size_t MaxParameters>
+struct StaticFunctionSpec
+{
+    constexpr StaticFunctionSpec()
+        : name(),
+          parameterCount(0),
+          parameters()
+    {}
+
+    FunctionSpec toFunctionSpec() const
+    {
+        FunctionSpec result{};
+        result.name = name.toString();
+        result.parameters.reserve(parameterCount);
+        for (size_t i = 0; i < parameterCount; ++i)
+        {
+            const StaticFunctionSpecParameter& param = parameters[i];
+            result.parameters.push_back(FunctionSpecParameter{param.name.toString(),
+                    param.hasValue ? boost::make_optional(param.value.toString()) : boost::none,
+                    InvalidSymbolId});
+        }
+
+        return result;
+    }
+
+    StaticStringRef name;
+    size_t parameterCount;
+    StaticFunctionSpecParameter parameters[MaxParameters];
+};
+
+/// Character classes matching the ones of Tokenizer.
+constexpr bool isStaticSpecWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+constexpr bool isStaticSpecDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool isStaticSpecNameCharacter(char c)
+{
+    return !isStaticSpecWhitespace(c) && !isStaticSpecDigit(c)
+            && c != '(' && c != ')' && c != '=' && c != '+' && c != '-' && c != '/' && c != '*'
+            && c != '.' && c != ',' && c != ':' && c != ';' && c != '?' && c != '"';
+}
+
+/// Number of commas outside of string literals plus one, never less than actual parameter count.
+constexpr size_t getStaticSpecParameterCapacity(const char* input, size_t size)
+{
+    size_t result = 1;
+    bool isQuoted = false;
+    bool isEscaped = false;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const char c = input[i];
+        if (isQuoted)
+        {
+            if (c == '\\')
+            {
+                isEscaped = !isEscaped;
+            }
+            else
+            {
+                isQuoted = isEscaped || c != '"';
+                isEscaped = false;
+            }
+        }
+        else if (c == '"')
+        {
+            isQuoted = true;
+        }
+        else if (c == ',')
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+template <size_t MaxParameters>
+class StaticFunctionSpecParser
+{
+public:
+    constexpr StaticFunctionSpecParser(const char* input, size_t size)
+        : input(input),
+          size(size),
+          position(0)
+    {}
+
+    /// Throws std::logic_error on malformed input, which is a compile error in constant expression.
+    constexpr StaticFunctionSpec<MaxParameters> parse()
+    {
+        StaticFunctionSpec<MaxParameters> result;
+
+        skipWhitespace();
+        result.name = parseName("expected function name");
+        skipWhitespace();
+        check(consume('('), "expected '('");
+        skipWhitespace();
+
+        // parsing arguments
+        while (!consume(')'))
+        {
+            check(result.parameterCount < MaxParameters, "too many parameters");
+            StaticFunctionSpecParameter& param = result.parameters[result.parameterCount++];
+
+            param.name = parseName("expected parameter name");
+            skipWhitespace();
+            if (consume('='))
+            {
+                // next is default value
+                skipWhitespace();
+                param.value = parseValue();
+                param.hasValue = true;
+                skipWhitespace();
+            }
+
+            if (consume(','))
+            {
+                // skip to the next argument, which must be present.
+                skipWhitespace();
+                check(peek() != ')', "expected parameter name");
+            }
+            else
+            {
+                check(peek() == ')', "expected ',' or ')'");
+            }
+        }
+
+        skipWhitespace();
+        check(position == size, "unexpected input after ')'");
+
+        return result;
+    }
+
+private:
+    static constexpr void check(bool condition, const char* message)
+    {
+        if (!condition)
+        {
+            throw std::logic_error(message);
+        }
+    }
+
+    constexpr char peek() const
+    {
+        return position < size ? input[position] : '\0';
+    }
+
+    constexpr bool consume(char c)
+    {
+        if (position < size && input[position] == c)
+        {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    constexpr void skipWhitespace()
+    {
+        while (position < size && isStaticSpecWhitespace(input[position]))
+        {
+            ++position;
+        }
+    }
+
+    constexpr StaticStringRef parseName(const char* message)
+    {
+        const size_t begin = position;
+        check(position < size && isStaticSpecNameCharacter(input[position]), message);
+
+        while (position < size
+                && (isStaticSpecNameCharacter(input[position]) || isStaticSpecDigit(input[position])))
+        {
+            ++position;
+        }
+        check(peek() != '.', "invalid name");
+
+        return StaticStringRef(input + begin, position - begin);
+    }
+
+    /// Number or string literal, string literal keeps quotes, like Lexer does.
+    constexpr StaticStringRef parseValue()
+    {
+        const size_t begin = position;
+        if (consume('"'))
+        {
+            bool isEscaped = false;
+            while (true)
+            {
+                check(position < size, "unterminated string literal");
+                const char c = input[position++];
+                if (c == '"' && !isEscaped)
+                {
+                    break;
+                }
+                isEscaped = (c == '\\') && !isEscaped;
+            }
+        }
+        else
+        {
+            check(isStaticSpecDigit(peek()), "expected number or string literal");
+            skipDigits();
+            if (consume('.'))
+            {
+                check(isStaticSpecDigit(peek()), "invalid number");
+                skipDigits();
+            }
+            check(position == size
+                    || (input[position] != '.' && !isStaticSpecNameCharacter(input[position])),
+                    "invalid number");
+        }
+
+        return StaticStringRef(input + begin, position - begin);
+    }
+
+    constexpr void skipDigits()
+    {
+        while (position < size && isStaticSpecDigit(input[position]))
+        {
+            ++position;
+        }
+    }
+
+private:
+    const char* input;
+    size_t size;
+    size_t position;
+};
+
+template <size_t MaxParameters>
+constexpr StaticFunctionSpec<MaxParameters> parseStaticFunctionSpec(const char* input, size_t size)
+{
+    return StaticFunctionSpecParser<MaxParameters>(input, size).parse();
+}
+
+/// Must be used to initialize a constexpr variable, otherwise errors are reported
+/// at run time with std::logic_error.
+#define STATIC_FUNCTION_SPEC(literal) \
+    parseStaticFunctionSpec<getStaticSpecParameterCapacity(literal, sizeof(literal) - 1)>( \
+            literal, sizeof(literal) - 1)
+
+#endif // EQUEUM_FUNCTION_PARSER_STATIC_FUNCTION_SPEC_H_INCLUDED
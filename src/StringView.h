@@ -0,0 +1,25 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_STRING_VIEW_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_STRING_VIEW_H_INCLUDED
+
+#include <boost/version.hpp>
+
+#if BOOST_VERSION < 106000
+    #include <boost/utility/string_ref.hpp>
+#else
+    #include <boost/utility/string_view.hpp>
+#endif
+
+// Hackety hack, compatibility with boost prior to 1.60.00
+#if BOOST_VERSION < 106000
+namespace boost
+{
+using string_view = boost::string_ref;
+}
+#endif
+
+#endif // EQUEUM_FUNCTION_PARSER_STRING_VIEW_H_INCLUDED
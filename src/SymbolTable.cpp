@@ -0,0 +1,62 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "SymbolTable.h"
+
+#include "Hash.h"
+
+size_t SymbolTable::NameHash::operator()(boost::string_view name) const
+{
+    return static_cast<size_t>(hashBytes(name));
+}
+
+SymbolTable::SymbolTable(MemoryResource* resource)
+    : names(ResourceAllocator<Name>(resource)),
+      ids(0, NameHash(), std::equal_to<boost::string_view>(), ResourceAllocator<IdsValue>(resource))
+{}
+
+SymbolTable::~SymbolTable()
+{}
+
+SymbolId SymbolTable::intern(boost::string_view name)
+{
+    const SymbolId existing = find(name);
+    if (existing != InvalidSymbolId)
+    {
+        return existing;
+    }
+
+    names.emplace_back(name.data(), name.size(), ResourceAllocator<char>(names.get_allocator()));
+    const SymbolId id = static_cast<SymbolId>(names.size());
+    ids.emplace(boost::string_view(names.back()), id);
+
+    return id;
+}
+
+SymbolId SymbolTable::find(boost::string_view name) const
+{
+    const auto p = ids.find(name);
+    if (p == ids.end())
+    {
+        return InvalidSymbolId;
+    }
+
+    return p->second;
+}
+
+boost::string_view SymbolTable::getName(SymbolId id) const
+{
+    if (id == InvalidSymbolId || id > names.size())
+    {
+        return boost::string_view();
+    }
+
+    return names[id - 1];
+}
+
+size_t SymbolTable::getSize() const
+{
+    return names.size();
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_SYMBOL_TABLE_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_SYMBOL_TABLE_H_INCLUDED
+
+#include "MemoryResource.h"
+#include "StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+typedef uint32_t SymbolId;
+
+/// Id of the name that is not in the table, zero so that it is a default for aggregates.
+const SymbolId InvalidSymbolId = 0;
+
+/// Maps names to small dense integer ids, starting from 1.
+/// Concurrent find() and getName() are safe as long as nobody calls intern().
+class SymbolTable
+{
+public:
+    /// Names and the index are allocated from resource, which must outlive the table.
+    explicit SymbolTable(MemoryResource* resource = getDefaultMemoryResource());
+    ~SymbolTable();
+
+    /// Returns id of the name, adding it to the table if necessary.
+    SymbolId intern(boost::string_view name);
+    /// Returns InvalidSymbolId if name is not in the table, never allocates.
+    SymbolId find(boost::string_view name) const;
+    /// Returns empty string for InvalidSymbolId or unknown ids.
+    boost::string_view getName(SymbolId id) const;
+
+    /// Number of interned names, all ids are less than or equal to it.
+    size_t getSize() const;
+
+private:
+    struct NameHash
+    {
+        size_t operator()(boost::string_view name) const;
+    };
+
+    typedef std::basic_string<char, std::char_traits<char>, ResourceAllocator<char>> Name;
+    typedef std::pair<const boost::string_view, SymbolId> IdsValue;
+
+    // Deque never relocates elements, so views of the names stay valid.
+    std::deque<Name, ResourceAllocator<Name>> names;
+    std::unordered_map<boost::string_view, SymbolId, NameHash, std::equal_to<boost::string_view>,
+            ResourceAllocator<IdsValue>> ids;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_SYMBOL_TABLE_H_INCLUDED
@@ -0,0 +1,155 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Pool and index of the worker running on the current thread, if any.
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : pendingTasks(0),
+      nextQueue(0),
+      stopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    queues.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        queues.emplace_back(new WorkerQueue);
+    }
+
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    tasksAvailable.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+    return threads.size();
+}
+
+std::future<void> ThreadPool::submit(Task task)
+{
+    // std::function requires copyable target, hence shared_ptr.
+    const auto packagedTask = std::make_shared<std::packaged_task<void ()>>(std::move(task));
+    std::future<void> result = packagedTask->get_future();
+
+    post([packagedTask]()
+    {
+        (*packagedTask)();
+    });
+
+    return result;
+}
+
+void ThreadPool::post(Task task)
+{
+    const size_t queueIndex = (currentPool == this)
+            ? currentWorkerIndex
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++pendingTasks;
+    }
+
+    {
+        WorkerQueue& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    tasksAvailable.notify_one();
+}
+
+bool ThreadPool::tryPopTask(size_t workerIndex, Task& task)
+{
+    {
+        // Newest task from own queue, it is most likely to have its data in cache.
+        WorkerQueue& queue = *queues[workerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+
+            return true;
+        }
+    }
+
+    // Oldest task from other queues, it is most likely to spawn more work.
+    for (size_t i = 1; i < queues.size(); ++i)
+    {
+        WorkerQueue& queue = *queues[(workerIndex + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t workerIndex)
+{
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    while (true)
+    {
+        Task task;
+        if (tryPopTask(workerIndex, task))
+        {
+            --pendingTasks;
+            task();
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        tasksAvailable.wait(lock, [this]()
+        {
+            return stopping || pendingTasks != 0;
+        });
+
+        // Drain the queues before stopping.
+        if (stopping && pendingTasks == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_THREAD_POOL_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_THREAD_POOL_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed-size pool of worker threads with work stealing.
+/// Each worker has its own queue: tasks submitted from a worker go to its queue
+/// and are executed LIFO, idle workers steal the oldest tasks from other queues.
+/// Tasks submitted from other threads are distributed round-robin.
+class ThreadPool
+{
+public:
+    typedef std::function<void ()> Task;
+
+    /// threadCount of 0 means one thread per hardware thread.
+    explicit ThreadPool(size_t threadCount = 0);
+    /// Waits for all submitted tasks to complete.
+    ~ThreadPool();
+
+    size_t getThreadCount() const;
+
+    /// Exception thrown by the task is reported via returned future.
+    std::future<void> submit(Task task);
+
+    /// Same as submit(), but without the future, task must not throw.
+    void post(Task task);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t workerIndex);
+    bool tryPopTask(size_t workerIndex, Task& task);
+
+private:
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    // Number of tasks in all queues, incremented under the mutex to avoid lost wakeups.
+    std::atomic<size_t> pendingTasks;
+    std::atomic<size_t> nextQueue;
+    std::mutex mutex;
+    std::condition_variable tasksAvailable;
+    bool stopping;
+};
+
+#endif // EQUEUM_FUNCTION_PARSER_THREAD_POOL_H_INCLUDED
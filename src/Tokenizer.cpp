@@ -5,6 +5,8 @@
 
 #include "Tokenizer.h"
 
+#include "Instrumentation.h"
+
 #include <algorithm>
 #include <limits>
 
@@ -28,6 +30,7 @@ TokenType getCharacterTokenType(char c)
         case ',':
         case ':':
         case ';':
+        case '?':
             return TOKEN_PUNCT;
     }
     if (isspace(c))
@@ -53,6 +56,7 @@ size_t getMaxTokenLength(TokenType type)
         case TOKEN_QUOTED_STRING:
         case TOKEN_STRING:
         case TOKEN_NUMBER:
+        case TOKEN_UNTERMINATED_STRING:
             return MaxTokenLength;
         case TOKEN_LPAR:
         case TOKEN_RPAR:
@@ -97,8 +101,8 @@ size_t findLengthOfStringLiteral(const boost::string_view& str)
 
 } // namespace
 
-Tokenizer::Tokenizer(const std::string& string)
-    : input(string)
+Tokenizer::Tokenizer(boost::string_view input)
+    : input(input)
 {
 }
 
@@ -115,10 +119,17 @@ Token Tokenizer::peekNextToken() const
     {
         tokenType = TOKEN_QUOTED_STRING;
         tokenLen = findLengthOfStringLiteral(input);
+        if (tokenLen == 0)
+        {
+            tokenType = TOKEN_UNTERMINATED_STRING;
+            tokenLen = input.size();
+        }
     }
     else
     {
-        const auto p = std::find_if_not(input.cbegin(), input.cend(),
+        // Scanning a run of single character tokens, like "((((", to its end would be quadratic.
+        const auto end = input.cbegin() + std::min(getMaxTokenLength(tokenType), input.size());
+        const auto p = std::find_if_not(input.cbegin(), end,
                 [tokenType](const char c) -> bool
         {
             return tokenType == getCharacterTokenType(c);
@@ -126,7 +137,6 @@ Token Tokenizer::peekNextToken() const
 
         tokenLen = p - input.begin();
     }
-    tokenLen = std::min(getMaxTokenLength(tokenType), tokenLen);
     const Token result{input.substr(0, tokenLen), tokenType};
 
     return result;
@@ -134,8 +144,10 @@ Token Tokenizer::peekNextToken() const
 
 Token Tokenizer::getNextToken()
 {
+    EQUEUM_INSTRUMENTATION_SCOPE(scope, INSTRUMENTATION_GET_NEXT_TOKEN);
     const Token result = peekNextToken();
     input.remove_prefix(result.value.length());
+    EQUEUM_INSTRUMENTATION_BYTES(scope, result.value.length());
 
     return result;
 }
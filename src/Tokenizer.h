@@ -6,23 +6,7 @@
 #ifndef EQUEUM_FUNCTION_PARSER_TOKENIZER_H_INCLUDED
 #define EQUEUM_FUNCTION_PARSER_TOKENIZER_H_INCLUDED
 
-#include <boost/version.hpp>
-
-#if BOOST_VERSION < 106000
-    #include <boost/utility/string_ref.hpp>
-#else
-    #include <boost/utility/string_view.hpp
-#endif
-
-#include <string>
-
-// Hackety hack, compatibility with boost prior to 1.60.00
-#if BOOST_VERSION < 106000
-namespace boost
-{
-using string_view = boost::string_ref;
-}
-#endif
+#include "StringView.h"
 
 enum TokenType : int
 {
@@ -30,10 +14,11 @@ enum TokenType : int
     TOKEN_LPAR,
     TOKEN_RPAR,
     TOKEN_OP, // = + - / *
-    TOKEN_PUNCT, // punctuation marks: .,;:
+    TOKEN_PUNCT, // punctuation marks: .,;:?
     TOKEN_QUOTED_STRING, // unquoted string literal
     TOKEN_STRING, // unquoted string literal
     TOKEN_NUMBER, // number without decimal point
+    TOKEN_UNTERMINATED_STRING, // quotation mark without closing one, up to the end of input
 
     TOKEN_END_OF_INPUT // the last token
 };
@@ -44,10 +29,11 @@ struct Token
     TokenType type;
 };
 
+/// Every token but TOKEN_END_OF_INPUT is non-empty, so the input is consumed in linear time.
 class Tokenizer
 {
 public:
-    explicit Tokenizer(const std::string& string);
+    explicit Tokenizer(boost::string_view input);
 
     Token peekNextToken() const;
     Token getNextToken();
@@ -0,0 +1,49 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#ifndef EQUEUM_FUNCTION_PARSER_TRACING_H_INCLUDED
+#define EQUEUM_FUNCTION_PARSER_TRACING_H_INCLUDED
+
+// USDT probes of provider "function_parser", for perf, bpftrace, SystemTap, etc:
+//
+//     bpftrace -e 'usdt:./server:function_parser:call__parse__end
+//             { printf("%s %d\n", str(arg2, arg3), arg4); }'
+//
+// Probes are a single nop unless traced. Enabled with CMake option FUNCTION_PARSER_USDT
+// when sys/sdt.h is available (systemtap-sdt-dev package), otherwise compile to nothing.
+// Strings are not NUL-terminated unless noted, pointer is followed by the length.
+//
+// call__parse__start(input, inputLength)
+// call__parse__end(input, inputLength, functionName, functionNameLength, errorCode, errorOffset)
+// lexeme(type, offset, length) - each lexeme emitted by the Lexer, errors included.
+// spec__register(functionName, parameterCount, added) - NUL-terminated name,
+//     added is 0 if function with the same name is already registered.
+// call__bind(functionName, parameterCount, errorCode) - FunctionRegistry::updateFunctionCall,
+//     NUL-terminated name, parameterCount of the call before defaults are added.
+
+#if defined(EQUEUM_FUNCTION_PARSER_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define EQUEUM_FUNCTION_PARSER_HAS_USDT
+#endif
+#endif
+
+#ifdef EQUEUM_FUNCTION_PARSER_HAS_USDT
+
+#define EQUEUM_TRACE_PROBE2(name, a1, a2) DTRACE_PROBE2(function_parser, name, a1, a2)
+#define EQUEUM_TRACE_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(function_parser, name, a1, a2, a3)
+#define EQUEUM_TRACE_PROBE6(name, a1, a2, a3, a4, a5, a6) \
+        DTRACE_PROBE6(function_parser, name, a1, a2, a3, a4, a5, a6)
+
+#else
+
+// Arguments are not evaluated.
+#define EQUEUM_TRACE_PROBE2(name, a1, a2) do {} while (false)
+#define EQUEUM_TRACE_PROBE3(name, a1, a2, a3) do {} while (false)
+#define EQUEUM_TRACE_PROBE6(name, a1, a2, a3, a4, a5, a6) do {} while (false)
+
+#endif // EQUEUM_FUNCTION_PARSER_HAS_USDT
+
+#endif // EQUEUM_FUNCTION_PARSER_TRACING_H_INCLUDED
@@ -7,6 +7,7 @@
 
 #include "FunctionParser.h"
 #include "Lexer.h"
+#include "ParseError.h"
 #include "Tokenizer.h"
 
 #include <boost/preprocessor/stringize.hpp>
@@ -47,6 +48,7 @@ std::ostream& operator<<(std::ostream& ostr, const TokenType& tokenType)
         TYPE_STRING(TOKEN_STRING),
         TYPE_STRING(TOKEN_QUOTED_STRING),
         TYPE_STRING(TOKEN_NUMBER),
+        TYPE_STRING(TOKEN_UNTERMINATED_STRING),
         TYPE_STRING(TOKEN_END_OF_INPUT),
     };
     return ostr << TokenTypeNames.at(tokenType);
@@ -63,11 +65,63 @@ std::ostream& operator<<(std::ostream& ostr, const LexemeType& lexType)
         TYPE_STRING(LEX_PUNCTUATION),
         TYPE_STRING(LEX_LEFT_PARENTHESIS),
         TYPE_STRING(LEX_RIGHT_PARENTHESIS),
-        TYPE_STRING(LEX_END_OF_INPUT)
+        TYPE_STRING(LEX_EXPRESSION),
+        TYPE_STRING(LEX_PLACEHOLDER),
+        TYPE_STRING(LEX_END_OF_INPUT),
+        TYPE_STRING(LEX_ERROR)
     };
     return ostr << LexTypeNames.at(lexType);
 }
 
+std::ostream& operator<<(std::ostream& ostr, const ParseErrorCode& errorCode)
+{
+    static const std::unordered_map<size_t, const char*> ParseErrorCodeNames =
+    {
+        TYPE_STRING(PARSE_ERROR_NONE),
+        TYPE_STRING(PARSE_ERROR_UNEXPECTED_CHARACTER),
+        TYPE_STRING(PARSE_ERROR_INVALID_NAME),
+        TYPE_STRING(PARSE_ERROR_INVALID_NUMBER),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_FUNCTION_NAME),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_PARAMETER_NAME),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_ASSIGNMENT),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_VALUE),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS),
+        TYPE_STRING(PARSE_ERROR_POSITIONAL_AFTER_NAMED),
+        TYPE_STRING(PARSE_ERROR_TRAILING_INPUT),
+        TYPE_STRING(PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS),
+        TYPE_STRING(PARSE_ERROR_NESTING_TOO_DEEP),
+        TYPE_STRING(PARSE_ERROR_UNTERMINATED_STRING),
+        TYPE_STRING(PARSE_ERROR_INPUT_TOO_LONG),
+        TYPE_STRING(PARSE_ERROR_TOO_MANY_LEXEMES),
+        TYPE_STRING(PARSE_ERROR_LITERAL_TOO_LONG),
+        TYPE_STRING(PARSE_ERROR_UNKNOWN_FUNCTION),
+        TYPE_STRING(PARSE_ERROR_UNKNOWN_PARAMETER),
+        TYPE_STRING(PARSE_ERROR_DUPLICATE_PARAMETER),
+        TYPE_STRING(PARSE_ERROR_TOO_MANY_PARAMETERS),
+        TYPE_STRING(PARSE_ERROR_MISSING_PARAMETER),
+        TYPE_STRING(PARSE_ERROR_INVALID_ARGUMENT_TYPE),
+        TYPE_STRING(PARSE_ERROR_INVALID_ENCODING),
+    };
+    return ostr << ParseErrorCodeNames.at(errorCode);
+}
+
+std::ostream& operator<<(std::ostream& ostr, const CallValueType& valueType)
+{
+    static const std::unordered_map<size_t, const char*> CallValueTypeNames =
+    {
+        TYPE_STRING(CALL_VALUE_NUMBER),
+        TYPE_STRING(CALL_VALUE_STRING),
+        TYPE_STRING(CALL_VALUE_EXPRESSION),
+    };
+    return ostr << CallValueTypeNames.at(valueType);
+}
+
+std::ostream& operator<<(std::ostream& ostr, const ParseError& error)
+{
+    return ostr << "ParseError{" << error.code << ", " << error.offset << "}";
+}
+
 std::ostream& operator<<(std::ostream& ostr, const Lexeme& lex)
 {
     return ostr << "Lexeme{\"" << lex.value << "\", " << lex.type << "}";
@@ -96,7 +150,7 @@ std::ostream& operator<<(std::ostream& ostr, const FunctionCallParameter& param)
         ostr << *param.name << " = ";
     }
 
-    return ostr << param.value;
+    return ostr << param.value << " : " << param.valueType;
 }
 
 std::ostream& operator<<(std::ostream& ostr, const FunctionCall& call)
@@ -116,6 +170,11 @@ std::ostream& operator<<(std::ostream& ostr, const FunctionCall& call)
 }
 
 
+bool operator==(const ParseError& left, const ParseError& right)
+{
+    return left.code == right.code && left.offset == right.offset;
+}
+
 bool operator==(const Lexeme& left, const Lexeme& right)
 {
     return left.type == right.type && left.value == right.value;
@@ -133,7 +192,7 @@ bool operator==(const FunctionSpecParameter& left, const FunctionSpecParameter&
 
 bool operator==(const FunctionCallParameter& left, const FunctionCallParameter& right)
 {
-    return isEqualParameters(left, right);
+    return isEqualParameters(left, right) && left.valueType == right.valueType;
 }
 
 bool operator==(const FunctionCall& left, const FunctionCall& right)
@@ -13,17 +13,24 @@ struct Token;
 struct FunctionCall;
 struct FunctionSpecParameter;
 struct FunctionCallParameter;
+struct ParseError;
 enum TokenType : int;
 enum LexemeType : int;
+enum ParseErrorCode : int;
+enum CallValueType : int;
 
 std::ostream& operator<<(std::ostream& ostr, const TokenType& tokenType);
 std::ostream& operator<<(std::ostream& ostr, const LexemeType& lexType);
+std::ostream& operator<<(std::ostream& ostr, const ParseErrorCode& errorCode);
+std::ostream& operator<<(std::ostream& ostr, const CallValueType& valueType);
+std::ostream& operator<<(std::ostream& ostr, const ParseError& error);
 std::ostream& operator<<(std::ostream& ostr, const Token& token);
 std::ostream& operator<<(std::ostream& ostr, const Lexeme& lex);
 std::ostream& operator<<(std::ostream& ostr, const FunctionSpecParameter& param);
 std::ostream& operator<<(std::ostream& ostr, const FunctionCallParameter& param);
 std::ostream& operator<<(std::ostream& ostr, const FunctionCall& call);
 
+bool operator==(const ParseError& left, const ParseError& right);
 bool operator==(const Token& left, const Token& right);
 bool operator==(const Lexeme& left, const Lexeme& right);
 bool operator==(const FunctionSpecParameter& left, const FunctionSpecParameter& right);
@@ -0,0 +1,137 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "AllocationCounter.h"
+#include "CallBinder.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+#include "Lexer.h"
+#include "ParserContext.h"
+#include "PreparedFunctionCall.h"
+#include "Tokenizer.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+// Paths that are expected not to allocate, so that regressions are caught by tests
+// rather than by benchmarks. Inputs are short enough for parameters to fit inline
+// and for strings to fit into SSO buffer.
+
+namespace
+{
+
+const char* const ShortCall = R"(f(1, 2.5, c=3, d="foo"))";
+
+} // namespace
+
+TEST(AllocationsTest, counter)
+{
+    AllocationScope allocations;
+    std::unique_ptr<std::string> value(new std::string(100, 'x'));
+
+    EXPECT_EQ(2u, allocations.getCount());
+    EXPECT_LE(sizeof(std::string) + 100u, allocations.getBytes());
+}
+
+TEST(AllocationsTest, tokenizerAndLexer)
+{
+    AllocationScope allocations;
+
+    Tokenizer tokenizer(ShortCall);
+    while (tokenizer.getNextToken().type != TOKEN_END_OF_INPUT)
+    {}
+
+    Lexer lexer(ShortCall);
+    while (lexer.getNextLexeme().type != LEX_END_OF_INPUT)
+    {}
+
+    EXPECT_EQ(0u, allocations.getCount());
+}
+
+TEST(AllocationsTest, parseFunctionCall)
+{
+    AllocationScope allocations;
+    const ParseResult<FunctionCall> call = tryParseFunctionCall(ShortCall);
+    ASSERT_TRUE(static_cast<bool>(call)) << call.getError();
+
+    EXPECT_EQ(0u, allocations.getCount());
+}
+
+TEST(AllocationsTest, parserContextReusesCall)
+{
+    const std::string longString(1000, 'x');
+    const std::string inputs[] =
+    {
+        ShortCall,
+        "g()",
+        R"(h(a=")" + longString + R"(", b=1 + 2 * g(3)))",
+        "f(1)",
+        R"(h(b=2, a=")" + longString + R"("))",
+    };
+
+    ParserContext context;
+    FunctionCall call;
+    // Warm up, memory of previous calls is reused by following ones.
+    for (const auto& input : inputs)
+    {
+        context.reset(input);
+        ASSERT_EQ(PARSE_ERROR_NONE, context.parseCall(call).code) << input;
+    }
+
+    for (const auto& input : inputs)
+    {
+        AllocationScope allocations;
+        context.reset(input);
+        ASSERT_EQ(PARSE_ERROR_NONE, context.parseCall(call).code) << input;
+
+        EXPECT_EQ(0u, allocations.getCount()) << input;
+    }
+}
+
+TEST(AllocationsTest, updateFunctionCall)
+{
+    FunctionRegistry registry;
+    registry.addFunction("f(a, b, c = 3, d = \"bar\")");
+    const ParseResult<FunctionCall> call = tryParseFunctionCall("f(1, d=\"foo\")", &registry.getSymbolTable());
+    ASSERT_TRUE(static_cast<bool>(call)) << call.getError();
+
+    AllocationScope allocations;
+    const FunctionCall updated = registry.updateFunctionCall(call.getValue());
+
+    EXPECT_EQ(0u, allocations.getCount());
+}
+
+TEST(AllocationsTest, preparedFunctionCallBind)
+{
+    FunctionRegistry registry;
+    registry.addFunction("f(a, b, c = 3)");
+    const auto prepared = prepareFunctionCall("f(?, b=?)", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+
+    const std::string values[] = {"1", R"("foo")"};
+    FunctionCall call;
+    prepared.getValue().bind(values, 2, call);
+
+    AllocationScope allocations;
+    prepared.getValue().bind(values, 2, call);
+
+    EXPECT_EQ(0u, allocations.getCount());
+}
+
+TEST(AllocationsTest, callBinder)
+{
+    const FunctionSpec spec = parseFunctionSpec("f(a, b, c = \"bar\")");
+    const auto binder = makeCallBinder<void (int64_t, double, boost::string_view)>(spec);
+    decltype(binder)::Arguments arguments;
+
+    AllocationScope allocations;
+    ASSERT_EQ(PARSE_ERROR_NONE, binder.bind(R"(f(1, c="foo", b=2.5))", arguments).code);
+
+    EXPECT_EQ(0u, allocations.getCount());
+}
@@ -0,0 +1,197 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "CallBinder.h"
+#include "FunctionParser.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <clocale>
+#include <cstdint>
+#include <locale>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace
+{
+
+typedef CallBinder<void (int64_t, double, boost::string_view)> Binder;
+
+Binder makeTestBinder()
+{
+    return makeCallBinder<void (int64_t, double, boost::string_view)>(
+            parseFunctionSpec(R"(f(a, b=0.5, c="foo"))"));
+}
+
+struct CallBinderErrorTestCase
+{
+    const char* input;
+    const ParseError expectedError;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const CallBinderErrorTestCase& testCase)
+{
+    return ostr << "CallBinderErrorTestCase{" << testCase.input << ", " << testCase.expectedError << "}";
+}
+
+class CallBinderErrorTest : public ::testing::TestWithParam<CallBinderErrorTestCase>
+{};
+
+} // namespace
+
+TEST(CallBinderTest, positional)
+{
+    const Binder binder = makeTestBinder();
+    const auto result = binder.bind(R"(f(1, 2.25, "bar"))");
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+
+    EXPECT_EQ(1, std::get<0>(result.getValue()));
+    EXPECT_EQ(2.25, std::get<1>(result.getValue()));
+    EXPECT_EQ("bar", std::get<2>(result.getValue()));
+}
+
+TEST(CallBinderTest, namedAndDefaults)
+{
+    const Binder binder = makeTestBinder();
+    const auto result = binder.bind(R"(f(c="baz", a=123456789012))");
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+
+    EXPECT_EQ(123456789012, std::get<0>(result.getValue()));
+    EXPECT_EQ(0.5, std::get<1>(result.getValue()));
+    EXPECT_EQ("baz", std::get<2>(result.getValue()));
+
+    const auto defaults = binder.bind("f(7)");
+    ASSERT_TRUE(static_cast<bool>(defaults)) << defaults.getError();
+    EXPECT_EQ(7, std::get<0>(defaults.getValue()));
+    EXPECT_EQ("foo", std::get<2>(defaults.getValue()));
+}
+
+TEST(CallBinderTest, stringViewPointsIntoInput)
+{
+    const Binder binder = makeTestBinder();
+    const std::string input = R"(f(1, c="bar"))";
+    Binder::Arguments arguments;
+
+    ASSERT_EQ((ParseError{PARSE_ERROR_NONE, 0}), binder.bind(input, arguments));
+    EXPECT_EQ(input.data() + 8, std::get<2>(arguments).data());
+}
+
+TEST(CallBinderTest, copiedBinderKeepsDefaults)
+{
+    Binder::Arguments arguments;
+    {
+        const Binder binder = makeTestBinder();
+        const Binder copy = binder;
+        ASSERT_EQ((ParseError{PARSE_ERROR_NONE, 0}), copy.bind("f(1)", arguments));
+    }
+    const Binder other = makeTestBinder();
+    ASSERT_EQ((ParseError{PARSE_ERROR_NONE, 0}), other.bind("f(2)", arguments));
+    EXPECT_EQ("foo", std::get<2>(arguments));
+}
+
+TEST(CallBinderTest, stringArguments)
+{
+    const auto binder = makeCallBinder<void (const std::string&, unsigned int)>(parseFunctionSpec("g(s, n=4294967295)"));
+    const auto result = binder.bind(R"(g("a\"b\\c"))");
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+
+    EXPECT_EQ(R"(a"b\c)", std::get<0>(result.getValue()));
+    EXPECT_EQ(4294967295u, std::get<1>(result.getValue()));
+}
+
+TEST(CallBinderTest, foldedConstants)
+{
+    const Binder binder = makeTestBinder();
+    const auto result = binder.bind("f(-60 * 60 * 24, b=1 / 4)");
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+
+    EXPECT_EQ(-86400, std::get<0>(result.getValue()));
+    EXPECT_EQ(0.25, std::get<1>(result.getValue()));
+
+    const auto unsignedBinder = makeCallBinder<void (unsigned int)>(parseFunctionSpec("g(n)"));
+    EXPECT_EQ((ParseError{PARSE_ERROR_INVALID_ARGUMENT_TYPE, 2}), unsignedBinder.bind("g(1 - 2)").getError());
+    EXPECT_TRUE(static_cast<bool>(unsignedBinder.bind("g(2 - 1)")));
+}
+
+TEST(CallBinderTest, realsIgnoreLocale)
+{
+    struct CommaNumpunct : std::numpunct<char>
+    {
+        char do_decimal_point() const override
+        {
+            return ',';
+        }
+    };
+
+    // Not every system has a locale with ',' as decimal point, C++ one is always there.
+    const std::string oldLocale = std::setlocale(LC_ALL, nullptr);
+    for (const char* name : {"de_DE.UTF-8", "de_DE", "ru_RU.UTF-8", "fr_FR.UTF-8"})
+    {
+        if (std::setlocale(LC_ALL, name))
+        {
+            break;
+        }
+    }
+    const std::locale oldGlobal = std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct));
+
+    const Binder binder = makeTestBinder();
+    // Long mantissa and many fraction digits take the slow path.
+    const auto longMantissa = binder.bind("f(1, b=1.50000000000000000001)");
+    const auto manyDigits = binder.bind("f(1, b=0.0000000000000000000000015)");
+
+    std::locale::global(oldGlobal);
+    std::setlocale(LC_ALL, oldLocale.c_str());
+
+    ASSERT_TRUE(static_cast<bool>(longMantissa)) << longMantissa.getError();
+    EXPECT_EQ(1.5, std::get<1>(longMantissa.getValue()));
+    ASSERT_TRUE(static_cast<bool>(manyDigits)) << manyDigits.getError();
+    EXPECT_EQ(1.5e-24, std::get<1>(manyDigits.getValue()));
+}
+
+TEST(CallBinderTest, invalidSpec)
+{
+    EXPECT_THROW(makeCallBinder<void (int)>(parseFunctionSpec("f(a, b)")), std::invalid_argument);
+    EXPECT_THROW(makeCallBinder<void (int)>(parseFunctionSpec("f(a=\"foo\")")), std::invalid_argument);
+    EXPECT_THROW(makeCallBinder<void (int8_t)>(parseFunctionSpec("f(a=300)")), std::invalid_argument);
+}
+
+TEST(CallBinderTest, noParameters)
+{
+    const auto binder = makeCallBinder<void ()>(parseFunctionSpec("f()"));
+    EXPECT_TRUE(static_cast<bool>(binder.bind("f()")));
+    EXPECT_EQ((ParseError{PARSE_ERROR_TOO_MANY_PARAMETERS, 2}), binder.bind("f(1)").getError());
+}
+
+TEST_P(CallBinderErrorTest, bind)
+{
+    const CallBinderErrorTestCase& testCase = GetParam();
+    const Binder binder = makeTestBinder();
+
+    EXPECT_EQ(testCase.expectedError, binder.bind(testCase.input).getError());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Errors,
+    CallBinderErrorTest,
+    ::testing::ValuesIn(std::vector<CallBinderErrorTestCase>{
+        {"g(1)",                {PARSE_ERROR_UNKNOWN_FUNCTION, 0}},
+        {"f(1, d=2)",           {PARSE_ERROR_UNKNOWN_PARAMETER, 5}},
+        {"f(1, a=2)",           {PARSE_ERROR_DUPLICATE_PARAMETER, 5}},
+        {R"(f(1, 2, "a", 3))",  {PARSE_ERROR_TOO_MANY_PARAMETERS, 13}},
+        {"f(b=1)",              {PARSE_ERROR_MISSING_PARAMETER, 6}},
+        {"f()",                 {PARSE_ERROR_MISSING_PARAMETER, 3}},
+        {R"(f("1"))",           {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 2}},
+        {"f(1.5)",              {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 2}},
+        {"f(99999999999999999999)", {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 2}},
+        {"f(1, 2, 3)",          {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 8}},
+        {R"(f(1, c="a\"b"))",   {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 5}},
+        {"f(1",                 {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 3}},
+        {"f(1 / 0)",            {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 2}},
+    }),
+);
@@ -0,0 +1,143 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ConstantFolding.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct ConstantFoldingTestCase
+{
+    ExpressionNodeType operation;
+    const char* left;
+    const char* right;
+    const char* expected; // nullptr if operation is not folded
+};
+
+std::ostream& operator<<(std::ostream& ostr, const ConstantFoldingTestCase& testCase)
+{
+    return ostr << "ConstantFoldingTestCase{" << testCase.operation << ", " << testCase.left
+                << ", " << testCase.right << ", " << (testCase.expected ? testCase.expected : "nullptr") << "}";
+}
+
+class ConstantFoldingTest : public ::testing::TestWithParam<ConstantFoldingTestCase>
+{};
+
+std::string writeConstant(const Constant& value)
+{
+    std::string result;
+    writeConstant(value, result);
+    return result;
+}
+
+} // namespace
+
+TEST_P(ConstantFoldingTest, foldConstant)
+{
+    const ConstantFoldingTestCase& testCase = GetParam();
+
+    Constant left{}, right{}, result{};
+    ASSERT_TRUE(parseConstant(testCase.left, left));
+    ASSERT_TRUE(parseConstant(testCase.right, right));
+
+    if (!testCase.expected)
+    {
+        EXPECT_FALSE(foldConstant(testCase.operation, left, right, result));
+        return;
+    }
+
+    ASSERT_TRUE(foldConstant(testCase.operation, left, right, result));
+    EXPECT_EQ(testCase.expected, writeConstant(result));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Arithmetic,
+    ConstantFoldingTest,
+    ::testing::ValuesIn(std::vector<ConstantFoldingTestCase>{
+        {EXPRESSION_MULTIPLY,   "86400",    "365",      "31536000"},
+        {EXPRESSION_ADD,        "-2",       "3",        "1"},
+        {EXPRESSION_SUBTRACT,   "2",        "3",        "-1"},
+        {EXPRESSION_DIVIDE,     "7",        "7",        "1"},
+        {EXPRESSION_DIVIDE,     "-8",       "2",        "-4"},
+        {EXPRESSION_DIVIDE,     "7",        "2",        "3.5"},
+        {EXPRESSION_DIVIDE,     "1",        "3",        "0.3333333333333333"},
+        {EXPRESSION_MULTIPLY,   "1.5",      "2",        "3.0"},
+        {EXPRESSION_ADD,        "0.1",      "0.2",      "0.30000000000000004"},
+        {EXPRESSION_DIVIDE,     "1",        "10000000", "0.0000001"},
+        {EXPRESSION_MULTIPLY,   "1.5",      "1000000000000000000000.0", "1500000000000000000000.0"},
+        {EXPRESSION_SUBTRACT,   "0.5",      "1",        "-0.5"},
+        // Integer overflow, division by zero and infinity are left to the callee.
+        {EXPRESSION_ADD,        "9223372036854775807",  "1",    nullptr},
+        {EXPRESSION_SUBTRACT,   "-9223372036854775807", "2",    nullptr},
+        {EXPRESSION_MULTIPLY,   "4294967296",   "4294967296",   nullptr},
+        {EXPRESSION_DIVIDE,     "1",        "0",        nullptr},
+        {EXPRESSION_DIVIDE,     "1.5",      "0.0",      nullptr},
+        // So are integers that don't convert to double exactly.
+        {EXPRESSION_MULTIPLY,   "9007199254740992",     "1.0",  "9007199254740992.0"},
+        {EXPRESSION_MULTIPLY,   "9007199254740993",     "1.0",  nullptr},
+        {EXPRESSION_ADD,        "0.5",  "9223372036854775807",  nullptr},
+        {EXPRESSION_DIVIDE,     "9007199254740993",     "2",    nullptr},
+        {EXPRESSION_DIVIDE,     "-9223372036854775808", "1.0",  "-9223372036854776000.0"},
+    }),
+);
+
+TEST(ConstantFoldingTest, negate)
+{
+    Constant operand{}, result{};
+
+    ASSERT_TRUE(parseConstant("5", operand));
+    ASSERT_TRUE(foldConstant(EXPRESSION_NEGATE, operand, result));
+    EXPECT_EQ("-5", writeConstant(result));
+
+    ASSERT_TRUE(parseConstant("-0.25", operand));
+    ASSERT_TRUE(foldConstant(EXPRESSION_NEGATE, operand, result));
+    EXPECT_EQ("0.25", writeConstant(result));
+
+    ASSERT_TRUE(parseConstant("-9223372036854775808", operand));
+    EXPECT_FALSE(foldConstant(EXPRESSION_NEGATE, operand, result));
+}
+
+TEST(ConstantFoldingTest, writtenRealsRoundTrip)
+{
+    for (const double value : {0.1, 1.0 / 3.0, 2.5e-300, 1.7976931348623157e308, 123456.789})
+    {
+        const std::string text = writeConstant(Constant{false, 0, value});
+        EXPECT_NE(std::string::npos, text.find('.')) << text;
+        EXPECT_EQ(std::string::npos, text.find('e')) << text;
+        EXPECT_EQ(value, std::strtod(text.c_str(), nullptr)) << text;
+    }
+}
+
+TEST(ConstantFoldingTest, infinity)
+{
+    const Constant large{false, 0, 1e300};
+    Constant result{};
+    EXPECT_FALSE(foldConstant(EXPRESSION_MULTIPLY, large, large, result));
+    EXPECT_TRUE(foldConstant(EXPRESSION_DIVIDE, large, large, result));
+}
+
+TEST(ConstantFoldingTest, parseConstant)
+{
+    Constant value{};
+    ASSERT_TRUE(parseConstant("-7", value));
+    EXPECT_TRUE(value.isInteger);
+    EXPECT_EQ(-7, value.integer);
+
+    ASSERT_TRUE(parseConstant("7.0", value));
+    EXPECT_FALSE(value.isInteger);
+    EXPECT_EQ(7.0, value.real);
+
+    // Integer literals must fit int64_t.
+    EXPECT_FALSE(parseConstant("99999999999999999999", value));
+    // Real ones must fit double.
+    EXPECT_FALSE(parseConstant("1" + std::string(400, '0') + ".0", value));
+}
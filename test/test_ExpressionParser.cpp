@@ -0,0 +1,183 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "Expression.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// Prints tree in prefix notation, like "(add 1 (mul 2 3))".
+void printNode(std::ostream& ostr, const ExpressionTree& tree, ExpressionNodeIndex index)
+{
+    static const char* const Operators[] = {"", "", "", "neg", "add", "sub", "mul", "div"};
+
+    const ExpressionNode& node = tree.getNode(index);
+    if (!node.name.empty())
+    {
+        ostr << node.name << "=";
+    }
+
+    if (node.type == EXPRESSION_NUMBER || node.type == EXPRESSION_STRING || node.type == EXPRESSION_INPUT)
+    {
+        ostr << node.value;
+        return;
+    }
+
+    ostr << "(" << (node.type == EXPRESSION_CALL ? node.value : boost::string_view(Operators[node.type]));
+    size_t childCount = 0;
+    for (ExpressionNodeIndex child = node.firstChild; child != InvalidExpressionNodeIndex;
+            child = tree.getNode(child).nextSibling)
+    {
+        ostr << " ";
+        printNode(ostr, tree, child);
+        ++childCount;
+    }
+    EXPECT_EQ(node.childCount, childCount);
+    ostr << ")";
+}
+
+std::string printTree(const ExpressionTree& tree)
+{
+    std::ostringstream ostr;
+    printNode(ostr, tree, tree.getRoot());
+    return ostr.str();
+}
+
+struct ExpressionParserTestCase
+{
+    const char* input;
+    const char* expected;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const ExpressionParserTestCase& testCase)
+{
+    return ostr << "ExpressionParserTestCase{" << testCase.input << ", " << testCase.expected << "}";
+}
+
+class ExpressionParserTest : public ::testing::TestWithParam<ExpressionParserTestCase>
+{};
+
+struct ExpressionParserErrorTestCase
+{
+    const char* input;
+    const ParseError error;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const ExpressionParserErrorTestCase& testCase)
+{
+    return ostr << "ExpressionParserErrorTestCase{" << testCase.input << ", " << testCase.error << "}";
+}
+
+class ExpressionParserErrorTest : public ::testing::TestWithParam<ExpressionParserErrorTestCase>
+{};
+
+} // namespace
+
+TEST_P(ExpressionParserTest, tryParseExpression)
+{
+    const ExpressionParserTestCase& testCase = GetParam();
+    const ParseResult<ExpressionTree> result = tryParseExpression(testCase.input);
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+
+    // Root is added last.
+    EXPECT_EQ(result.getValue().getSize() - 1, result.getValue().getRoot());
+    EXPECT_EQ(testCase.expected, printTree(result.getValue()));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Expressions,
+    ExpressionParserTest,
+    ::testing::ValuesIn(std::vector<ExpressionParserTestCase>{
+        {"1",                           "1"},
+        {R"("foo")",                    R"("foo")"},
+        {"f()",                         "(f)"},
+        {"f() + 2 * g()",               "(add (f) (mul 2 (g)))"},
+        {"(f() + 2) * 3",               "(mul (add (f) 2) 3)"},
+        {"f() - 2 - 3",                 "(sub (sub (f) 2) 3)"},
+        {"f() / 4 / 2",                 "(div (div (f) 4) 2)"},
+        {"-f() * -+g()",                "(mul (neg (f)) (neg (g)))"},
+        {"--f()",                       "(neg (neg (f)))"},
+        // Constant folding
+        {"1 + 2 * 3",                   "7"},
+        {"(1 + 2) * 3",                 "9"},
+        {"1 - 2 - 3",                   "-4"},
+        {"8 / 4 / 2",                   "1"},
+        {"7 / 2",                       "3.5"},
+        {"-1 * -+2",                    "2"},
+        {"--1",                         "1"},
+        {"60 * 60 * 24",                "86400"},
+        {"f(g(1), 2+3)",                "(f (g 1) 5)"},
+        {"2 * 3 + f()",                 "(add 6 (f))"},
+        {"f() + 2 * 3",                 "(add (f) 6)"},
+        {"1 / 0",                       "(div 1 0)"},
+        {"9223372036854775807 + 1",     "(add 9223372036854775807 1)"},
+        {R"("a" + 1)",                  R"((add "a" 1))"},
+        {R"(f(1, x=g(y="a") * 2.5))",   R"((f 1 x=(mul (g y="a") 2.5)))"},
+        {"f(x=(((1))))",                "(f x=1)"},
+        {"f(g(h(i())))",                "(f (g (h (i))))"},
+    }),
+);
+
+TEST_P(ExpressionParserErrorTest, tryParseExpression)
+{
+    const ExpressionParserErrorTestCase& testCase = GetParam();
+    EXPECT_EQ(testCase.error, tryParseExpression(testCase.input).getError());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Errors,
+    ExpressionParserErrorTest,
+    ::testing::ValuesIn(std::vector<ExpressionParserErrorTestCase>{
+        {"",                {PARSE_ERROR_EXPECTED_VALUE, 0}},
+        {"1 +",             {PARSE_ERROR_EXPECTED_VALUE, 3}},
+        {"1 2",             {PARSE_ERROR_TRAILING_INPUT, 2}},
+        {"(1",              {PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS, 2}},
+        {"f",               {PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS, 1}},
+        {"f(1",             {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 3}},
+        {"f(a=1, 2)",       {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 7}},
+        {"1 + .",           {PARSE_ERROR_UNEXPECTED_CHARACTER, 4}},
+        {"1 = 2",           {PARSE_ERROR_TRAILING_INPUT, 2}},
+    }),
+);
+
+TEST(ExpressionParserTest, inputs)
+{
+    const ParseResult<ExpressionTree> result = tryParseExpression("f(?, x=? * 2) + -?", true);
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+    EXPECT_EQ("(add (f ? x=(mul ? 2)) (neg ?))", printTree(result.getValue()));
+
+    EXPECT_EQ((ParseError{PARSE_ERROR_EXPECTED_VALUE, 4}), tryParseExpression("1 + ?").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_POSITIONAL_AFTER_NAMED, 7}), tryParseExpression("f(a=1, ?)", true).getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_TRAILING_INPUT, 2}), tryParseExpression("? ?", true).getError());
+}
+
+TEST(ExpressionParserTest, nestingTooDeep)
+{
+    const std::string deepParentheses = std::string(1000, '(') + "1" + std::string(1000, ')');
+    EXPECT_EQ(PARSE_ERROR_NESTING_TOO_DEEP, tryParseExpression(deepParentheses).getError().code);
+
+    std::string deepCalls;
+    for (int i = 0; i < 1000; ++i)
+    {
+        deepCalls += "f(";
+    }
+    deepCalls += std::string(1000, ')');
+    EXPECT_EQ(PARSE_ERROR_NESTING_TOO_DEEP, tryParseExpression(deepCalls).getError().code);
+
+    const std::string deepNegation = std::string(1000, '-') + "1";
+    EXPECT_EQ(PARSE_ERROR_NESTING_TOO_DEEP, tryParseExpression(deepNegation).getError().code);
+
+    const std::string shallow = std::string(100, '(') + "1" + std::string(100, ')');
+    EXPECT_TRUE(static_cast<bool>(tryParseExpression(shallow)));
+}
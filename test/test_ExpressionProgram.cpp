@@ -0,0 +1,282 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ExpressionProgram.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+/// price() returns a different value on each call.
+void addTestFunctions(ExpressionFunctionTable& functions, double& price)
+{
+    functions.addFunction("add(a, b=10)", [](const ExpressionValue* arguments, size_t)
+    {
+        return arguments[0].number + arguments[1].number;
+    });
+    functions.addFunction("sub(a, b)", [](const ExpressionValue* arguments, size_t)
+    {
+        return arguments[0].number - arguments[1].number;
+    });
+    functions.addFunction(R"(length(s, suffix=""))", [](const ExpressionValue* arguments, size_t)
+    {
+        return static_cast<double>(arguments[0].string.size() + arguments[1].string.size());
+    });
+    functions.addFunction("price()", [&price](const ExpressionValue*, size_t)
+    {
+        return price++;
+    });
+}
+
+class ExpressionProgramTest : public ::testing::Test
+{
+protected:
+    ExpressionProgramTest()
+        : price(0)
+    {
+        addTestFunctions(functions, price);
+    }
+
+    double evaluate(boost::string_view input) const
+    {
+        const ParseResult<ExpressionProgram> program = compileExpression(input, functions);
+        EXPECT_TRUE(static_cast<bool>(program)) << program.getError();
+
+        const ExpressionValue result = program.getValue().evaluate();
+        EXPECT_EQ(EXPRESSION_VALUE_NUMBER, result.type);
+        return result.number;
+    }
+
+    ExpressionFunctionTable functions;
+    double price;
+};
+
+struct ExpressionProgramErrorTestCase
+{
+    const char* input;
+    const ParseError error;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const ExpressionProgramErrorTestCase& testCase)
+{
+    return ostr << "ExpressionProgramErrorTestCase{" << testCase.input << ", " << testCase.error << "}";
+}
+
+class ExpressionProgramErrorTest : public ::testing::TestWithParam<ExpressionProgramErrorTestCase>
+{};
+
+} // namespace
+
+TEST_F(ExpressionProgramTest, evaluate)
+{
+    EXPECT_EQ(7, evaluate("1 + 2 * 3"));
+    EXPECT_EQ(13, evaluate("add(1, 2) * sub(5, 1) + 1"));
+    EXPECT_EQ(-2, evaluate("sub(b=3, a=1)"));
+    EXPECT_EQ(11, evaluate("add(1)"));
+    EXPECT_EQ(2.5, evaluate("add(b=-add(0, 0.5), a=3)"));
+    EXPECT_EQ(5, evaluate(R"(length("a\"b", suffix="cd"))"));
+    EXPECT_EQ(3, evaluate(R"(length("abc"))"));
+    EXPECT_EQ(0.5, evaluate("1 / add(1, b=1)"));
+}
+
+TEST_F(ExpressionProgramTest, evaluateManyTimes)
+{
+    const ParseResult<ExpressionProgram> program = compileExpression("price() * 2 + add(price())", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+
+    // Copies share nothing mutable with the original.
+    const ExpressionProgram copy = program.getValue();
+    EXPECT_EQ(11, copy.evaluate().number);
+    EXPECT_EQ(2 * 2 + 13, program.getValue().evaluate().number);
+    EXPECT_EQ(2 * 4 + 15, copy.evaluate().number);
+}
+
+TEST_F(ExpressionProgramTest, stringResult)
+{
+    const ParseResult<ExpressionProgram> program = compileExpression(R"(("a\\b"))", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+
+    const ExpressionValue result = program.getValue().evaluate();
+    EXPECT_EQ(EXPRESSION_VALUE_STRING, result.type);
+    EXPECT_EQ(R"(a\b)", result.string);
+}
+
+TEST_F(ExpressionProgramTest, code)
+{
+    const ParseResult<ExpressionProgram> program = compileExpression("sub(b=2, a=price()) * 3", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+
+    // Arguments are reordered to spec order at compile time.
+    const std::vector<ExpressionOpcode> expected = {OPCODE_CALL, OPCODE_PUSH_NUMBER, OPCODE_CALL,
+            OPCODE_PUSH_NUMBER, OPCODE_MULTIPLY, OPCODE_RETURN};
+    std::vector<ExpressionOpcode> opcodes;
+    for (const auto& instruction : program.getValue().getCode())
+    {
+        opcodes.push_back(instruction.opcode);
+    }
+    EXPECT_EQ(expected, opcodes);
+    EXPECT_EQ(2u, program.getValue().getStackSize());
+}
+
+TEST_F(ExpressionProgramTest, deepStack)
+{
+    // Right-nested operators keep every left operand on the stack.
+    std::string input;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        input += "price() + (";
+    }
+    input += "1" + std::string(100, ')');
+
+    const ParseResult<ExpressionProgram> program = compileExpression(input, functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+    EXPECT_EQ(101u, program.getValue().getStackSize());
+    EXPECT_EQ(99 * 100 / 2 + 1, program.getValue().evaluate().number);
+}
+
+TEST_F(ExpressionProgramTest, replacedFunction)
+{
+    const ParseResult<ExpressionProgram> program = compileExpression("sub(3, 1)", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+
+    functions.addFunction("sub(a, b)", [](const ExpressionValue*, size_t)
+    {
+        return 0.0;
+    });
+    EXPECT_EQ(2, program.getValue().evaluate().number);
+    EXPECT_EQ(0, evaluate("sub(3, 1)"));
+}
+
+TEST_F(ExpressionProgramTest, exceptions)
+{
+    functions.addFunction("fail()", [](const ExpressionValue*, size_t) -> double
+    {
+        throw std::runtime_error("fail");
+    });
+
+    const ParseResult<ExpressionProgram> program = compileExpression("1 + fail()", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+    EXPECT_THROW(program.getValue().evaluate(), std::runtime_error);
+}
+
+TEST_F(ExpressionProgramTest, inputs)
+{
+    // Inputs are numbered in order of appearance, not in evaluation order.
+    const ParseResult<ExpressionProgram> program = compileExpression("sub(b=?, a=?) * ? + length(?)", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+    ASSERT_EQ(4u, program.getValue().getInputCount());
+
+    ExpressionValue inputs[4] = {};
+    inputs[0].number = 1;
+    inputs[1].number = 5;
+    inputs[2].number = 10;
+    inputs[3].type = EXPRESSION_VALUE_STRING;
+    inputs[3].string = "abc";
+    EXPECT_EQ((5 - 1) * 10 + 3, program.getValue().evaluate(inputs, 4).number);
+
+    // Compiled once, evaluated with different inputs.
+    inputs[2].number = 100;
+    ExpressionValue stack[8];
+    ASSERT_LE(program.getValue().getStackSize(), 8u);
+    EXPECT_EQ((5 - 1) * 100 + 3, program.getValue().evaluate(inputs, 4, stack).number);
+
+    EXPECT_THROW(program.getValue().evaluate(), std::invalid_argument);
+    EXPECT_THROW(program.getValue().evaluate(inputs, 3), std::invalid_argument);
+    // Operand of arithmetic must be a number.
+    std::swap(inputs[2], inputs[3]);
+    EXPECT_THROW(program.getValue().evaluate(inputs, 4), std::invalid_argument);
+}
+
+TEST_F(ExpressionProgramTest, inputResult)
+{
+    const ParseResult<ExpressionProgram> program = compileExpression("(?)", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+
+    ExpressionValue input{EXPRESSION_VALUE_STRING, 0, "foo"};
+    const ExpressionValue result = program.getValue().evaluate(&input, 1);
+    EXPECT_EQ(EXPRESSION_VALUE_STRING, result.type);
+    EXPECT_EQ("foo", result.string);
+
+    const std::vector<ExpressionOpcode> expected = {OPCODE_LOAD_INPUT, OPCODE_RETURN};
+    EXPECT_EQ(expected.size(), program.getValue().getCode().size());
+    EXPECT_EQ(OPCODE_LOAD_INPUT, program.getValue().getCode()[0].opcode);
+}
+
+TEST(ExpressionFunctionTableTest, registrySymbols)
+{
+    FunctionRegistry registry;
+    registry.addFunction("g(x)");
+    ExpressionFunctionTable functions(registry);
+    functions.addFunction("twice(a)", [](const ExpressionValue* arguments, size_t)
+    {
+        return arguments[0].number * 2;
+    });
+
+    // Function is registered, ids of calls parsed with the registry find it in the table.
+    EXPECT_EQ(&registry.getSymbolTable(), &functions.getSymbolTable());
+    EXPECT_NE(nullptr, registry.findFunctionSpecByName("twice"));
+    const FunctionCall call = parseFunctionCall("twice(1)", &registry.getSymbolTable());
+    ASSERT_NE(nullptr, functions.findFunction(call.nameId));
+    EXPECT_EQ("twice", functions.findFunction(call.nameId)->spec.name);
+
+    // Registered but not implemented.
+    EXPECT_EQ(nullptr, functions.findFunction("g"));
+    EXPECT_THROW(functions.addFunction("g(y)", nullptr), std::invalid_argument);
+    functions.addFunction("g(x)", [](const ExpressionValue* arguments, size_t)
+    {
+        return arguments[0].number + 1;
+    });
+
+    const ParseResult<ExpressionProgram> program = compileExpression("twice(g(x=?))", functions);
+    ASSERT_TRUE(static_cast<bool>(program)) << program.getError();
+    const ExpressionValue input{EXPRESSION_VALUE_NUMBER, 2, boost::string_view()};
+    EXPECT_EQ(6, program.getValue().evaluate(&input, 1).number);
+}
+
+TEST_F(ExpressionProgramTest, invalidDefault)
+{
+    // Parsed specs always have literal defaults.
+    const FunctionSpec spec{"f", {FunctionSpecParameter{"a", std::string("b"), InvalidSymbolId}}, InvalidSymbolId};
+    EXPECT_THROW(functions.addFunction(spec, nullptr), std::invalid_argument);
+    EXPECT_THROW(functions.addFunction("f(a=b)", nullptr), ParseException);
+}
+
+TEST_P(ExpressionProgramErrorTest, compileExpression)
+{
+    const ExpressionProgramErrorTestCase& testCase = GetParam();
+    ExpressionFunctionTable functions;
+    double price = 0;
+    addTestFunctions(functions, price);
+
+    EXPECT_EQ(testCase.error, compileExpression(testCase.input, functions).getError());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Errors,
+    ExpressionProgramErrorTest,
+    ::testing::ValuesIn(std::vector<ExpressionProgramErrorTestCase>{
+        {"f()",                     {PARSE_ERROR_UNKNOWN_FUNCTION, 0}},
+        {"1 + add(c=1)",            {PARSE_ERROR_UNKNOWN_PARAMETER, 10}},
+        {"add(1, a=2)",             {PARSE_ERROR_DUPLICATE_PARAMETER, 9}},
+        {"add(1, 2, 3)",            {PARSE_ERROR_TOO_MANY_PARAMETERS, 10}},
+        {"sub(1)",                  {PARSE_ERROR_MISSING_PARAMETER, 0}},
+        {R"(1 + "a")",              {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 4}},
+        {R"(-length("a") * -"b")",  {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 16}},
+        {"add(1,",                  {PARSE_ERROR_EXPECTED_VALUE, 6}},
+        {R"(1 + ("a"))",            {PARSE_ERROR_INVALID_ARGUMENT_TYPE, 5}},
+        {"add(a=1, ?)",             {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 9}},
+    }),
+);
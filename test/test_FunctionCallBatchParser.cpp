@@ -0,0 +1,63 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallBatchParser.h"
+#include "ThreadPool.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+class FunctionCallBatchParserTest : public ::testing::TestWithParam<size_t>
+{};
+
+TEST_P(FunctionCallBatchParserTest, parseFunctionCalls)
+{
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        if (i % 7 == 3)
+        {
+            inputs.push_back("bad(");
+        }
+        else
+        {
+            inputs.push_back("f(" + std::to_string(i) + ", \"" + std::string(i % 100, 'x') + "\")");
+        }
+    }
+    const std::vector<boost::string_view> views(inputs.begin(), inputs.end());
+
+    ThreadPool pool(GetParam());
+    const std::vector<ParseResult<FunctionCall>> results = parseFunctionCalls(views, pool);
+
+    ASSERT_EQ(inputs.size(), results.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        const ParseResult<FunctionCall> expected = tryParseFunctionCall(inputs[i]);
+        ASSERT_EQ(bool(expected), bool(results[i]));
+        if (expected)
+        {
+            EXPECT_EQ(expected.getValue(), results[i].getValue());
+        }
+        else
+        {
+            EXPECT_EQ(expected.getError(), results[i].getError());
+        }
+    }
+}
+
+TEST_P(FunctionCallBatchParserTest, empty)
+{
+    ThreadPool pool(GetParam());
+    EXPECT_TRUE(parseFunctionCalls(std::vector<boost::string_view>(), pool).empty());
+}
+
+INSTANTIATE_TEST_CASE_P(
+        Threads, FunctionCallBatchParserTest,
+        ::testing::Values(1, 2, 3, 8),
+);
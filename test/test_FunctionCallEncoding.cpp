@@ -0,0 +1,171 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallEncoding.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class FunctionCallEncodingTest : public ::testing::TestWithParam<const char*>
+{};
+
+} // namespace
+
+TEST_P(FunctionCallEncodingTest, roundTrip)
+{
+    const FunctionCall call = parseFunctionCall(GetParam());
+    const std::string encoded = encodeFunctionCall(call);
+
+    const ParseResult<EncodedFunctionCallView> view = EncodedFunctionCallView::read(encoded);
+    ASSERT_TRUE(static_cast<bool>(view)) << view.getError();
+    EXPECT_EQ(call.parameters.size(), view.getValue().getParameterCount());
+
+    const ParseResult<FunctionCall> decoded = decodeFunctionCall(view.getValue());
+    ASSERT_TRUE(static_cast<bool>(decoded)) << decoded.getError();
+    EXPECT_EQ(call, decoded.getValue());
+}
+
+TEST_P(FunctionCallEncodingTest, truncated)
+{
+    const std::string encoded = encodeFunctionCall(parseFunctionCall(GetParam()));
+    for (size_t size = 0; size < encoded.size(); ++size)
+    {
+        const ParseResult<EncodedFunctionCallView> view = EncodedFunctionCallView::read(
+                boost::string_view(encoded.data(), size));
+        EXPECT_EQ(PARSE_ERROR_INVALID_ENCODING, view.getError().code) << "size: " << size;
+    }
+
+    EXPECT_EQ((ParseError{PARSE_ERROR_INVALID_ENCODING, encoded.size()}),
+            EncodedFunctionCallView::read(encoded + '\0').getError());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Calls,
+    FunctionCallEncodingTest,
+    ::testing::Values(
+        "f()",
+        R"(function(1, 0, 007, 12.5, 18446744073709551615, 18446744073709551616, "", "a\"b", c=3, d="foo"))",
+        R"(g(a="yes", b=0.0))",
+        R"(h("a" + "b", g(1), c=-(2) * x(), d="1"))"
+    ),
+);
+
+TEST(FunctionCallEncodingTest, view)
+{
+    const std::string encoded = encodeFunctionCall(parseFunctionCall(R"(f(123, 4.5, c="foo"))"));
+    const EncodedFunctionCallView view = EncodedFunctionCallView::read(encoded).getValue();
+
+    EXPECT_EQ(InvalidSymbolId, view.getName().id);
+    EXPECT_EQ("f", view.getName().name);
+
+    std::vector<EncodedParameter> parameters(view.begin(), view.end());
+    ASSERT_EQ(3u, parameters.size());
+
+    EXPECT_FALSE(parameters[0].hasName);
+    EXPECT_EQ(ENCODED_VALUE_INTEGER, parameters[0].valueType);
+    EXPECT_EQ(123u, parameters[0].integer);
+
+    EXPECT_EQ(ENCODED_VALUE_NUMBER, parameters[1].valueType);
+    EXPECT_EQ("4.5", parameters[1].text);
+
+    EXPECT_TRUE(parameters[2].hasName);
+    EXPECT_EQ("c", parameters[2].name.name);
+    EXPECT_EQ(ENCODED_VALUE_STRING, parameters[2].valueType);
+    EXPECT_EQ("foo", parameters[2].text);
+    // Zero-copy
+    EXPECT_TRUE(parameters[2].text.data() > encoded.data()
+            && parameters[2].text.data() < encoded.data() + encoded.size());
+}
+
+TEST(FunctionCallEncodingTest, expressions)
+{
+    // Types come from the parser, text that looks like a literal is not one.
+    const std::string encoded = encodeFunctionCall(parseFunctionCall(R"(f("a" + "b", g(1), 2 + 3))"));
+    const EncodedFunctionCallView view = EncodedFunctionCallView::read(encoded).getValue();
+
+    std::vector<EncodedParameter> parameters(view.begin(), view.end());
+    ASSERT_EQ(3u, parameters.size());
+
+    EXPECT_EQ(ENCODED_VALUE_EXPRESSION, parameters[0].valueType);
+    EXPECT_EQ(R"("a" + "b")", parameters[0].text);
+
+    EXPECT_EQ(ENCODED_VALUE_EXPRESSION, parameters[1].valueType);
+    EXPECT_EQ("g(1)", parameters[1].text);
+
+    // Folded constant is a literal.
+    EXPECT_EQ(ENCODED_VALUE_INTEGER, parameters[2].valueType);
+    EXPECT_EQ(5u, parameters[2].integer);
+}
+
+TEST(FunctionCallEncodingTest, nameIds)
+{
+    FunctionRegistry registry;
+    registry.addFunction("function(a, b=1)");
+    const SymbolTable& symbols = registry.getSymbolTable();
+
+    const FunctionCall call = parseFunctionCall(R"(function(1, b="foo"))", &symbols);
+    const std::string withIds = encodeFunctionCall(call, ENCODE_NAME_IDS);
+    const std::string withNames = encodeFunctionCall(call);
+    EXPECT_LT(withIds.size(), withNames.size());
+
+    const EncodedFunctionCallView view = EncodedFunctionCallView::read(withIds).getValue();
+    EXPECT_EQ(call.nameId, view.getName().id);
+    EXPECT_TRUE(view.getName().name.empty());
+
+    EXPECT_EQ(call, decodeFunctionCall(view, &symbols).getValue());
+    const EncodedFunctionCallView namesView = EncodedFunctionCallView::read(withNames).getValue();
+    EXPECT_EQ(InvalidSymbolId, namesView.getName().id);
+    EXPECT_EQ(call, decodeFunctionCall(namesView, &symbols).getValue());
+    // Names don't need the table.
+    const FunctionCall decoded = decodeFunctionCall(namesView).getValue();
+    EXPECT_EQ(call, decoded);
+    EXPECT_EQ(InvalidSymbolId, decoded.nameId);
+}
+
+TEST(FunctionCallEncodingTest, unknownNameIds)
+{
+    FunctionRegistry registry;
+    registry.addFunction("function(a, b=1)");
+    const FunctionCall call = parseFunctionCall(R"(function(1, b="foo"))", &registry.getSymbolTable());
+    const std::string encoded = encodeFunctionCall(call, ENCODE_NAME_IDS);
+    const EncodedFunctionCallView view = EncodedFunctionCallView::read(encoded).getValue();
+
+    // Ids can't be resolved without the table.
+    EXPECT_EQ((ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, 1}), decodeFunctionCall(view).getError());
+
+    // Nor with the table that doesn't have them.
+    SymbolTable symbols;
+    symbols.intern("function");
+    symbols.intern("a");
+    const ParseError error = decodeFunctionCall(view, &symbols).getError();
+    EXPECT_EQ(PARSE_ERROR_UNKNOWN_PARAMETER, error.code);
+    EXPECT_EQ(static_cast<char>(ENCODED_VALUE_STRING | 0x4), encoded[error.offset - 1]);
+}
+
+TEST(FunctionCallEncodingTest, malformed)
+{
+    const std::vector<std::string> inputs =
+    {
+        std::string("\x01\x02" "f\x00", 4), // unknown version
+        std::string("\x02\x01\x00", 3), // InvalidSymbolId
+        std::string("\x02\x02" "f\x01\x08\x00", 6), // bad parameter header
+        std::string("\x02\x02" "f\x01\x00\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x02", 15), // varint overflow
+        std::string("\x02\x02" "f\xFF\xFF\xFF\xFF\x0F", 7), // huge parameter count
+    };
+
+    for (const auto& input : inputs)
+    {
+        EXPECT_EQ(PARSE_ERROR_INVALID_ENCODING, EncodedFunctionCallView::read(input).getError().code);
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallFileParser.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace
+{
+
+std::string makeInput(size_t lineCount)
+{
+    std::string input;
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        if (i % 10 == 5)
+        {
+            input += "\n";
+        }
+        else if (i % 10 == 7)
+        {
+            input += "bad(,)\r\n";
+        }
+        else
+        {
+            input += "f(" + std::to_string(i) + ", b=\"" + std::string(i % 13, 'x') + "\")\n";
+        }
+    }
+
+    return input;
+}
+
+void checkResults(const std::string& input, const std::vector<ParsedFunctionCallLine>& results)
+{
+    size_t lineNumber = 0;
+    size_t lineStart = 0;
+    auto result = results.begin();
+    while (lineStart < input.size())
+    {
+        const size_t lineEnd = input.find('\n', lineStart);
+        std::string line = input.substr(lineStart, lineEnd - lineStart);
+        lineStart = (lineEnd == std::string::npos) ? input.size() : lineEnd + 1;
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+
+        ASSERT_NE(results.end(), result);
+        EXPECT_EQ(lineNumber, result->lineNumber);
+        EXPECT_EQ(line, result->line.to_string());
+
+        const ParseResult<FunctionCall> expected = tryParseFunctionCall(line);
+        ASSERT_EQ(bool(expected), bool(result->call));
+        if (expected)
+        {
+            EXPECT_EQ(expected.getValue(), result->call.getValue());
+        }
+        else
+        {
+            EXPECT_EQ(expected.getError(), result->call.getError());
+        }
+        ++result;
+    }
+    EXPECT_EQ(results.end(), result);
+}
+
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(const std::string& contents)
+    {
+        char pathTemplate[] = "/tmp/test_function_parser_XXXXXX";
+        const int fd = mkstemp(pathTemplate);
+        path = pathTemplate;
+        if (fd >= 0)
+        {
+            const ssize_t written = write(fd, contents.data(), contents.size());
+            static_cast<void>(written);
+            close(fd);
+        }
+    }
+
+    ~TemporaryFile()
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+} // namespace
+
+class FunctionCallFileParserTest : public ::testing::TestWithParam<size_t>
+{};
+
+TEST_P(FunctionCallFileParserTest, parseFunctionCallLines)
+{
+    ThreadPool pool(4);
+    const std::string input = makeInput(1000);
+
+    checkResults(input, parseFunctionCallLines(input, pool, GetParam()));
+}
+
+TEST_P(FunctionCallFileParserTest, noTrailingNewline)
+{
+    ThreadPool pool(3);
+    const std::string input = "a(1)\n\nb(2)\nc(3)";
+
+    checkResults(input, parseFunctionCallLines(input, pool, GetParam()));
+}
+
+TEST_P(FunctionCallFileParserTest, parseFunctionCallFile)
+{
+    ThreadPool pool(4);
+    const std::string input = makeInput(1000);
+    TemporaryFile file(input);
+
+    MappedFile mappedFile(file.path);
+    ASSERT_EQ(input, mappedFile.getData().to_string());
+
+    checkResults(input, parseFunctionCallFile(mappedFile, pool, GetParam()));
+}
+
+// 0 is for automatic chunk size.
+INSTANTIATE_TEST_CASE_P(
+        ChunkSize, FunctionCallFileParserTest,
+        ::testing::Values(0, 1, 10, 100, 1000),
+);
+
+TEST(FunctionCallFileParserTest, emptyFile)
+{
+    ThreadPool pool(2);
+    TemporaryFile file("");
+
+    MappedFile mappedFile(file.path);
+    EXPECT_TRUE(parseFunctionCallFile(mappedFile, pool).empty());
+}
+
+TEST(FunctionCallFileParserTest, missingFile)
+{
+    EXPECT_THROW(MappedFile("/nonexistent/file"), std::system_error);
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionCallStreamParser.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+
+struct ParsedLine
+{
+    std::string line;
+    size_t lineNumber;
+    bool success;
+    FunctionCall call;
+};
+
+FunctionCallStreamParser::Callback makeCollector(std::vector<ParsedLine>& lines)
+{
+    return [&lines](const ParseResult<FunctionCall>& result, boost::string_view line, size_t lineNumber)
+    {
+        lines.push_back(ParsedLine{line.to_string(), lineNumber, bool(result), result.getValue()});
+    };
+}
+
+const char Input[] =
+        "first(1, 2)\n"
+        "\n"
+        "second(a=\"some longer string literal\")\r\n"
+        "bad(\n"
+        "third()";
+
+void checkParsedLines(const std::vector<ParsedLine>& lines)
+{
+    ASSERT_EQ(4u, lines.size());
+
+    EXPECT_EQ(1u, lines[0].lineNumber);
+    EXPECT_TRUE(lines[0].success);
+    EXPECT_EQ(parseFunctionCall("first(1, 2)"), lines[0].call);
+
+    EXPECT_EQ(3u, lines[1].lineNumber);
+    EXPECT_TRUE(lines[1].success);
+    EXPECT_EQ(parseFunctionCall(R"(second(a="some longer string literal"))"), lines[1].call);
+
+    EXPECT_EQ(4u, lines[2].lineNumber);
+    EXPECT_EQ("bad(", lines[2].line);
+    EXPECT_FALSE(lines[2].success);
+
+    EXPECT_EQ(5u, lines[3].lineNumber);
+    EXPECT_TRUE(lines[3].success);
+    EXPECT_EQ(parseFunctionCall("third()"), lines[3].call);
+}
+
+} // namespace
+
+class FunctionCallStreamParserTest : public ::testing::TestWithParam<size_t>
+{};
+
+TEST_P(FunctionCallStreamParserTest, istream)
+{
+    std::istringstream input(Input);
+    std::vector<ParsedLine> lines;
+
+    FunctionCallStreamParser parser(GetParam());
+    EXPECT_EQ(5u, parser.parse(input, makeCollector(lines)));
+
+    checkParsedLines(lines);
+}
+
+TEST_P(FunctionCallStreamParserTest, fileDescriptor)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(Input) - 1), write(fds[1], Input, sizeof(Input) - 1));
+    close(fds[1]);
+
+    std::vector<ParsedLine> lines;
+    FunctionCallStreamParser parser(GetParam());
+    EXPECT_EQ(5u, parser.parse(fds[0], makeCollector(lines)));
+    close(fds[0]);
+
+    checkParsedLines(lines);
+}
+
+TEST_P(FunctionCallStreamParserTest, reuse)
+{
+    FunctionCallStreamParser parser(GetParam());
+    for (int i = 0; i < 3; ++i)
+    {
+        std::istringstream input(Input);
+        std::vector<ParsedLine> lines;
+
+        EXPECT_EQ(5u, parser.parse(input, makeCollector(lines)));
+        checkParsedLines(lines);
+    }
+}
+
+TEST_P(FunctionCallStreamParserTest, tooLongLine)
+{
+    const std::string longLine = "long(" + std::string(100, '1') + ")";
+    std::istringstream input("first()\n" + longLine + "\n" + longLine + "\nlast(1)");
+    std::vector<ParsedLine> lines;
+    ParseLimits limits = DefaultParseLimits;
+    limits.maxInputLength = 20;
+
+    // Buffer doesn't grow beyond the limit, whatever the length of the line.
+    FunctionCallStreamParser parser(GetParam(), limits);
+    EXPECT_EQ(4u, parser.parse(input, makeCollector(lines)));
+
+    ASSERT_EQ(4u, lines.size());
+    EXPECT_TRUE(lines[0].success);
+    for (size_t i = 1; i < 3; ++i)
+    {
+        EXPECT_EQ(i + 1, lines[i].lineNumber);
+        EXPECT_FALSE(lines[i].success);
+        EXPECT_EQ(0u, longLine.find(lines[i].line));
+    }
+    EXPECT_EQ(4u, lines[3].lineNumber);
+    EXPECT_EQ(parseFunctionCall("last(1)"), lines[3].call);
+}
+
+// Small chunk sizes make lines straddle chunk boundaries and outgrow the buffer.
+INSTANTIATE_TEST_CASE_P(
+        ChunkSize, FunctionCallStreamParserTest,
+        ::testing::Values(1, 2, 3, 7, 16, FunctionCallStreamParser::DefaultChunkSize),
+);
@@ -0,0 +1,154 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionDispatcher.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+std::string repeat(const std::string& str, int64_t count)
+{
+    std::string result;
+    for (int64_t i = 0; i < count; ++i)
+    {
+        result += str;
+    }
+    return result;
+}
+
+FunctionDispatcher<std::string> makeTestDispatcher()
+{
+    FunctionDispatcher<std::string> dispatcher;
+    dispatcher.addFunction<std::string (const std::string&, int64_t)>("repeat(str, count=2)", &repeat);
+    dispatcher.addFunction<std::string (double, double)>("add(a, b)", [](double a, double b)
+    {
+        return std::to_string(a + b);
+    });
+    dispatcher.addFunction<std::string ()>("hello()", []()
+    {
+        return std::string("hello");
+    });
+
+    return dispatcher;
+}
+
+} // namespace
+
+TEST(FunctionDispatcherTest, dispatch)
+{
+    const FunctionDispatcher<std::string> dispatcher = makeTestDispatcher();
+
+    EXPECT_EQ("abab", dispatcher.dispatch(R"(repeat("ab"))").getValue());
+    EXPECT_EQ("xxx", dispatcher.dispatch(R"(repeat(count=3, str="x"))").getValue());
+    EXPECT_EQ(std::to_string(4.0), dispatcher.dispatch("add(1.5, 2.5)").getValue());
+    EXPECT_EQ("hello", dispatcher.dispatch(" hello ( ) ").getValue());
+}
+
+TEST(FunctionDispatcherTest, replace)
+{
+    FunctionDispatcher<int> dispatcher;
+    dispatcher.addFunction<int (int)>("f(a)", [](int a) { return a; });
+    dispatcher.addFunction<int (int)>("f(a=5)", [](int a) { return a * 2; });
+
+    EXPECT_EQ(10, dispatcher.dispatch("f()").getValue());
+    EXPECT_EQ(4, dispatcher.dispatch("f(2)").getValue());
+}
+
+TEST(FunctionDispatcherTest, errors)
+{
+    const FunctionDispatcher<std::string> dispatcher = makeTestDispatcher();
+
+    EXPECT_EQ((ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, 1}), dispatcher.dispatch(" unknown()").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_EXPECTED_FUNCTION_NAME, 0}), dispatcher.dispatch("(1)").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_UNEXPECTED_CHARACTER, 0}), dispatcher.dispatch(".f()").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_MISSING_PARAMETER, 8}), dispatcher.dispatch("repeat()").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_INVALID_ARGUMENT_TYPE, 4}), dispatcher.dispatch(R"(add("1", 2))").getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 8}),
+            dispatcher.dispatch("add(1, 2").getError());
+}
+
+TEST(FunctionDispatcherTest, invalidSpec)
+{
+    FunctionDispatcher<int> dispatcher;
+    EXPECT_THROW(dispatcher.addFunction<int (int)>("f(a, b)", [](int a) { return a; }), std::invalid_argument);
+    EXPECT_THROW(dispatcher.addFunction<int (int)>("f(a", [](int a) { return a; }), ParseException);
+    EXPECT_EQ((ParseError{PARSE_ERROR_UNKNOWN_FUNCTION, 0}), dispatcher.dispatch("f(1)").getError());
+}
+
+TEST(FunctionDispatcherTest, exceptionsArePropagated)
+{
+    FunctionDispatcher<int> dispatcher;
+    dispatcher.addFunction<int ()>("fail()", []() -> int { throw std::runtime_error("fail"); });
+
+    EXPECT_THROW(dispatcher.dispatch("fail()"), std::runtime_error);
+}
+
+TEST(FunctionDispatcherTest, pureFunctionResultsAreCached)
+{
+    int invocations = 0;
+    FunctionDispatcher<int64_t> dispatcher(2);
+    dispatcher.addFunction<int64_t (int64_t, int64_t)>("add(a, b=24)", [&invocations](int64_t a, int64_t b)
+    {
+        ++invocations;
+        return a + b;
+    }, FUNCTION_PURE);
+    dispatcher.addFunction<int64_t (int64_t)>("impure(a)", [&invocations](int64_t a)
+    {
+        return a + ++invocations;
+    });
+
+    // Same call after filling in defaults.
+    EXPECT_EQ(25, dispatcher.dispatch("add(1)").getValue());
+    EXPECT_EQ(25, dispatcher.dispatch("add(a=1, b=24)").getValue());
+    EXPECT_EQ(25, dispatcher.dispatch("add(b=24, a=1)").getValue());
+    EXPECT_EQ(1, invocations);
+
+    const ResultCacheStatistics statistics = dispatcher.getResultCacheStatistics("add");
+    EXPECT_EQ(2u, statistics.hits);
+    EXPECT_EQ(1u, statistics.misses);
+    EXPECT_EQ(1u, statistics.size);
+
+    // Failed calls are neither cached nor counted.
+    EXPECT_FALSE(static_cast<bool>(dispatcher.dispatch("add(b=1)")));
+    EXPECT_EQ(3u, dispatcher.getResultCacheStatistics("add").hits + dispatcher.getResultCacheStatistics("add").misses);
+
+    EXPECT_EQ(2, dispatcher.dispatch("impure(0)").getValue());
+    EXPECT_EQ(3, dispatcher.dispatch("impure(0)").getValue());
+    EXPECT_EQ(0u, dispatcher.getResultCacheStatistics("impure").hits);
+
+    EXPECT_THROW(dispatcher.getResultCacheStatistics("unknown"), std::out_of_range);
+}
+
+TEST(FunctionDispatcherTest, resultCacheIsBounded)
+{
+    int invocations = 0;
+    FunctionDispatcher<std::string> dispatcher(2);
+    dispatcher.addFunction<std::string (const std::string&)>("f(s)", [&invocations](const std::string& s)
+    {
+        ++invocations;
+        return s + s;
+    }, FUNCTION_PURE);
+
+    EXPECT_EQ("aa", dispatcher.dispatch(R"(f("a"))").getValue());
+    EXPECT_EQ("bb", dispatcher.dispatch(R"(f("b"))").getValue());
+    EXPECT_EQ("aa", dispatcher.dispatch(R"(f("a"))").getValue());
+    EXPECT_EQ(2, invocations);
+
+    // Evicts least recently used "b".
+    EXPECT_EQ("cc", dispatcher.dispatch(R"(f("c"))").getValue());
+    EXPECT_EQ(2u, dispatcher.getResultCacheStatistics("f").size);
+    EXPECT_EQ("aa", dispatcher.dispatch(R"(f("a"))").getValue());
+    EXPECT_EQ(3, invocations);
+    EXPECT_EQ("bb", dispatcher.dispatch(R"(f("b"))").getValue());
+    EXPECT_EQ(4, invocations);
+}
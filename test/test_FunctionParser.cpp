@@ -137,9 +137,9 @@ const FunctionParserCallTestCase CallTestCases[] =
         {
             "function",
             {
-                FunctionCallParameter{UnsetOptionalString, "1"},
-                FunctionCallParameter{UnsetOptionalString, "2"},
-                FunctionCallParameter{std::string("c"), "3"}
+                FunctionCallParameter{UnsetOptionalString, "1", CALL_VALUE_NUMBER},
+                FunctionCallParameter{UnsetOptionalString, "2", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("c"), "3", CALL_VALUE_NUMBER}
             }
         }
     },
@@ -148,10 +148,41 @@ const FunctionParserCallTestCase CallTestCases[] =
         {
             "function",
             {
-                FunctionCallParameter{UnsetOptionalString, R"("a")"},
-                FunctionCallParameter{UnsetOptionalString, "2"},
-                FunctionCallParameter{std::string("c"), "3"},
-                FunctionCallParameter{std::string("d"), R"("foobar")"},
+                FunctionCallParameter{UnsetOptionalString, R"("a")", CALL_VALUE_STRING},
+                FunctionCallParameter{UnsetOptionalString, "2", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("c"), "3", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("d"), R"("foobar")", CALL_VALUE_STRING},
+            }
+        }
+    },
+    {
+        // expressions are kept as source text, constant arithmetic is folded
+        R"(function(g(1, x="a"), 2+3 , c = -(4) * 5, d=(6), e=h(), f=("x"), g="a" + "b"))",
+        {
+            "function",
+            {
+                FunctionCallParameter{UnsetOptionalString, R"(g(1, x="a"))", CALL_VALUE_EXPRESSION},
+                FunctionCallParameter{UnsetOptionalString, "5", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("c"), "-20", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("d"), "6", CALL_VALUE_NUMBER},
+                FunctionCallParameter{std::string("e"), "h()", CALL_VALUE_EXPRESSION},
+                FunctionCallParameter{std::string("f"), R"("x")", CALL_VALUE_STRING},
+                FunctionCallParameter{std::string("g"), R"("a" + "b")", CALL_VALUE_EXPRESSION},
+            }
+        }
+    },
+    {
+        // folding that would lose precision or fail is left to the callee
+        R"(f(60*60*24, 1.5*2, -0.5, 1/0, 9223372036854775807+1, 9007199254740993*1.0))",
+        {
+            "f",
+            {
+                FunctionCallParameter{UnsetOptionalString, "86400", CALL_VALUE_NUMBER},
+                FunctionCallParameter{UnsetOptionalString, "3.0", CALL_VALUE_NUMBER},
+                FunctionCallParameter{UnsetOptionalString, "-0.5", CALL_VALUE_NUMBER},
+                FunctionCallParameter{UnsetOptionalString, "1/0", CALL_VALUE_EXPRESSION},
+                FunctionCallParameter{UnsetOptionalString, "9223372036854775807+1", CALL_VALUE_EXPRESSION},
+                FunctionCallParameter{UnsetOptionalString, "9007199254740993*1.0", CALL_VALUE_EXPRESSION},
             }
         }
     }
@@ -178,3 +209,111 @@ INSTANTIATE_TEST_CASE_P(
         Simple, FunctionParserCallTest,
         ::testing::ValuesIn(CallTestCases),
 );
+
+struct FunctionParserErrorTestCase
+{
+    const char* input;
+    const ParseError error;
+};
+
+inline std::ostream& operator<<(std::ostream& ostr, const FunctionParserErrorTestCase& testCase)
+{
+    return ostr << "FunctionParserErrorTestCase{\n\t\"" << testCase.input << "\""
+            << ",\n\t" << testCase.error << "\n}";
+}
+
+const FunctionParserErrorTestCase CallErrorTestCases[] =
+{
+    {"", {PARSE_ERROR_EXPECTED_FUNCTION_NAME, 0}},
+    {"123()", {PARSE_ERROR_EXPECTED_FUNCTION_NAME, 0}},
+    {"f", {PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS, 1}},
+    {"f 1", {PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS, 2}},
+    {"f(", {PARSE_ERROR_EXPECTED_VALUE, 2}},
+    {"f(1", {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 3}},
+    {"f(1 2)", {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 4}},
+    {"f(,1)", {PARSE_ERROR_EXPECTED_VALUE, 2}},
+    {"f(1,)", {PARSE_ERROR_EXPECTED_VALUE, 4}},
+    {"f(a 1)", {PARSE_ERROR_EXPECTED_ASSIGNMENT, 4}},
+    {"f(a=)", {PARSE_ERROR_EXPECTED_VALUE, 4}},
+    {"f(a=1, 2)", {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 7}},
+    {"f(1.2.3)", {PARSE_ERROR_INVALID_NUMBER, 5}},
+    {"f(1.)", {PARSE_ERROR_INVALID_NUMBER, 2}},
+    {"f(.5)", {PARSE_ERROR_UNEXPECTED_CHARACTER, 2}},
+    {"f.g()", {PARSE_ERROR_INVALID_NAME, 1}},
+    {"f() g", {PARSE_ERROR_TRAILING_INPUT, 4}},
+    {"f(1+)", {PARSE_ERROR_EXPECTED_VALUE, 4}},
+    {"f(1*+)", {PARSE_ERROR_EXPECTED_VALUE, 5}},
+    {"f((1)", {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 5}},
+    {"f((1, 2))", {PARSE_ERROR_EXPECTED_RIGHT_PARENTHESIS, 4}},
+    {"f(g)", {PARSE_ERROR_EXPECTED_ASSIGNMENT, 3}},
+    {"f(1 + g)", {PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS, 7}},
+    {"f(g(a=1, 2))", {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 9}},
+    {"f(a=1, g(2))", {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 7}},
+    {"f(g(1,))", {PARSE_ERROR_EXPECTED_VALUE, 6}},
+    {"f(1 + 2.3.4)", {PARSE_ERROR_INVALID_NUMBER, 9}},
+    {"f(\"abc", {PARSE_ERROR_UNTERMINATED_STRING, 2}},
+    {"f(a=1, b=\"x\\\")", {PARSE_ERROR_UNTERMINATED_STRING, 9}},
+    {"f(1 + \"", {PARSE_ERROR_UNTERMINATED_STRING, 6}},
+};
+
+const FunctionParserErrorTestCase SpecErrorTestCases[] =
+{
+    {"", {PARSE_ERROR_EXPECTED_FUNCTION_NAME, 0}},
+    {"f", {PARSE_ERROR_EXPECTED_LEFT_PARENTHESIS, 1}},
+    {"f(1)", {PARSE_ERROR_EXPECTED_PARAMETER_NAME, 2}},
+    {"f(a,)", {PARSE_ERROR_EXPECTED_PARAMETER_NAME, 4}},
+    {"f(a b)", {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 4}},
+    {"f(a=)", {PARSE_ERROR_EXPECTED_VALUE, 4}},
+    {"f(a=b)", {PARSE_ERROR_EXPECTED_VALUE, 4}},
+    {"f(a=1.2.3)", {PARSE_ERROR_INVALID_NUMBER, 7}},
+    {"f(a)(", {PARSE_ERROR_TRAILING_INPUT, 4}},
+    {"f(a=\"x)", {PARSE_ERROR_UNTERMINATED_STRING, 4}},
+};
+
+class FunctionParserCallErrorTest : public ::testing::TestWithParam<FunctionParserErrorTestCase>
+{};
+
+TEST_P(FunctionParserCallErrorTest, tryParseFunctionCall)
+{
+    const FunctionParserErrorTestCase& testCase = GetParam();
+    const ParseResult<FunctionCall> result = tryParseFunctionCall(testCase.input);
+
+    ASSERT_FALSE(result);
+    EXPECT_EQ(testCase.error, result.getError());
+}
+
+TEST_P(FunctionParserCallErrorTest, parseFunctionCall)
+{
+    const FunctionParserErrorTestCase& testCase = GetParam();
+
+    EXPECT_THROW(parseFunctionCall(testCase.input), ParseException);
+}
+
+INSTANTIATE_TEST_CASE_P(
+        Simple, FunctionParserCallErrorTest,
+        ::testing::ValuesIn(CallErrorTestCases),
+);
+
+class FunctionParserSpecErrorTest : public ::testing::TestWithParam<FunctionParserErrorTestCase>
+{};
+
+TEST_P(FunctionParserSpecErrorTest, tryParseFunctionSpec)
+{
+    const FunctionParserErrorTestCase& testCase = GetParam();
+    const ParseResult<FunctionSpec> result = tryParseFunctionSpec(testCase.input);
+
+    ASSERT_FALSE(result);
+    EXPECT_EQ(testCase.error, result.getError());
+}
+
+TEST_P(FunctionParserSpecErrorTest, parseFunctionSpec)
+{
+    const FunctionParserErrorTestCase& testCase = GetParam();
+
+    EXPECT_THROW(parseFunctionSpec(testCase.input), ParseException);
+}
+
+INSTANTIATE_TEST_CASE_P(
+        Simple, FunctionParserSpecErrorTest,
+        ::testing::ValuesIn(SpecErrorTestCases),
+);
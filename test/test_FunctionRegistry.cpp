@@ -12,6 +12,7 @@
 #include <boost/optional.hpp>
 
 #include <ostream>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
@@ -51,6 +52,51 @@ const FunctionRegistryTestCase FunctionRegistryTestCases[] =
                 FunctionCallParameter{std::string("d"), "10"}
             }
         }
+    },
+    {
+        // parameters with defaults given positionally are not duplicated.
+        "f(a, b=24, c=56)",
+        // Original:
+       "f(1, 2)",
+        // Updated:
+        FunctionCall
+        {
+            "f",
+            {
+                FunctionCallParameter{std::string("a"), "1"},
+                FunctionCallParameter{std::string("b"), "2"},
+                FunctionCallParameter{std::string("c"), "56"}
+            }
+        }
+    },
+    {
+        "f(a, b=24)",
+        // Original:
+       "f(b=1, a=2)",
+        // Updated:
+        FunctionCall
+        {
+            "f",
+            {
+                FunctionCallParameter{std::string("a"), "2"},
+                FunctionCallParameter{std::string("b"), "1"}
+            }
+        }
+    },
+    {
+        // value types are kept, defaults are literals.
+        R"(f(a, b="x"))",
+        // Original:
+       "f(g(1))",
+        // Updated:
+        FunctionCall
+        {
+            "f",
+            {
+                FunctionCallParameter{std::string("a"), "g(1)", CALL_VALUE_EXPRESSION},
+                FunctionCallParameter{std::string("b"), R"("x")", CALL_VALUE_STRING}
+            }
+        }
     }
 };
 
@@ -75,7 +121,64 @@ TEST_P(FunctionRegistryTest, BasicTest)
     registry.deleteFunctionSpecByName(name);
 }
 
+TEST_P(FunctionRegistryTest, SymbolIds)
+{
+    const auto& testCase = GetParam();
+
+    FunctionRegistry registry;
+    registry.addFunction(testCase.input);
+    const SymbolTable& symbols = registry.getSymbolTable();
+
+    const FunctionCall call = parseFunctionCall(testCase.call, &symbols);
+    EXPECT_EQ(symbols.find(testCase.updatedCall.name), call.nameId);
+
+    const FunctionCall updated = registry.updateFunctionCall(call);
+    ASSERT_EQ(testCase.updatedCall, updated);
+
+    EXPECT_EQ(symbols.find(updated.name), updated.nameId);
+    for (const auto& param : updated.parameters)
+    {
+        EXPECT_NE(InvalidSymbolId, param.nameId);
+        EXPECT_EQ(*param.name, symbols.getName(param.nameId));
+    }
+}
+
 INSTANTIATE_TEST_CASE_P(
         Simple, FunctionRegistryTest,
         ::testing::ValuesIn(FunctionRegistryTestCases),
 );
+
+TEST(FunctionRegistryTest, UnknownFunction)
+{
+    FunctionRegistry registry;
+    registry.addFunction("f(a)");
+
+    EXPECT_THROW(registry.getFunctionSpecByName("g"), std::out_of_range);
+    EXPECT_THROW(registry.getFunctionSpecByName("a"), std::out_of_range);
+    EXPECT_THROW(registry.updateFunctionCall(parseFunctionCall("g(1)")), std::out_of_range);
+}
+
+TEST(FunctionRegistryTest, TooManyParameters)
+{
+    FunctionRegistry registry;
+    registry.addFunction("f(a)");
+
+    EXPECT_THROW(registry.updateFunctionCall(parseFunctionCall("f(1, 2)")), std::invalid_argument);
+}
+
+TEST(FunctionRegistryTest, DeleteFunction)
+{
+    FunctionRegistry registry;
+    EXPECT_EQ("f", registry.addFunction("f(a, b=1)"));
+    EXPECT_EQ("f", registry.getFunctionSpecByName("f").name);
+
+    EXPECT_TRUE(registry.deleteFunctionSpecByName("f"));
+    EXPECT_FALSE(registry.deleteFunctionSpecByName("f"));
+    EXPECT_THROW(registry.getFunctionSpecByName("f"), std::out_of_range);
+    EXPECT_EQ(nullptr, registry.findFunctionSpecByName("f"));
+
+    EXPECT_EQ("f", registry.addFunction("f(c)"));
+    EXPECT_EQ("c", registry.getFunctionSpecByName("f").parameters.at(0).name);
+    ASSERT_NE(nullptr, registry.findFunctionSpecByName("f"));
+    EXPECT_EQ("c", registry.findFunctionSpecByName("f")->parameters.at(0).name);
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionWriter.h"
+#include "ArgumentConverter.h"
+#include "FunctionParser.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+
+struct FunctionWriterTestCase
+{
+    const char* input;
+    const char* expected;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const FunctionWriterTestCase& testCase)
+{
+    return ostr << "FunctionWriterTestCase{" << testCase.input << ", " << testCase.expected << "}";
+}
+
+class FunctionCallWriterTest : public ::testing::TestWithParam<FunctionWriterTestCase>
+{};
+
+class FunctionSpecWriterTest : public ::testing::TestWithParam<FunctionWriterTestCase>
+{};
+
+} // namespace
+
+TEST_P(FunctionCallWriterTest, write)
+{
+    const FunctionWriterTestCase& testCase = GetParam();
+    const FunctionCall call = parseFunctionCall(testCase.input);
+
+    std::string output = "prefix ";
+    writeFunctionCall(call, output);
+    EXPECT_EQ(std::string("prefix ") + testCase.expected, output);
+
+    EXPECT_EQ(call, parseFunctionCall(formatFunctionCall(call)));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Calls,
+    FunctionCallWriterTest,
+    ::testing::ValuesIn(std::vector<FunctionWriterTestCase>{
+        {"f()",                                         "f()"},
+        {" f ( ) ",                                     "f()"},
+        {"f(1)",                                        "f(1)"},
+        {R"(function(1 , 2.5,c = 3, d="a,\"b"))",       R"(function(1, 2.5, c=3, d="a,\"b"))"},
+    }),
+);
+
+TEST_P(FunctionSpecWriterTest, write)
+{
+    const FunctionWriterTestCase& testCase = GetParam();
+    const FunctionSpec spec = parseFunctionSpec(testCase.input);
+
+    std::string output;
+    writeFunctionSpec(spec, output);
+    EXPECT_EQ(testCase.expected, output);
+
+    EXPECT_EQ(testCase.expected, formatFunctionSpec(parseFunctionSpec(output)));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Specs,
+    FunctionSpecWriterTest,
+    ::testing::ValuesIn(std::vector<FunctionWriterTestCase>{
+        {"f()",                                         "f()"},
+        {"f( a )",                                      "f(a)"},
+        {R"(f(a, b = 1.5 ,c="x\\"))",                   R"(f(a, b=1.5, c="x\\"))"},
+    }),
+);
+
+TEST(StringLiteralWriterTest, write)
+{
+    const std::string values[] =
+    {
+        "",
+        "a",
+        "\"",
+        "\\",
+        "no escapes, longer than a word",
+        R"(quote " in the middle of a long string)",
+        R"("""""""""""""""""")",
+        R"(\\\\\\\\\\"\\\\\\\\\\)",
+        R"(12345678"12345678\1234567)",
+    };
+
+    for (const auto& value : values)
+    {
+        std::string literal;
+        writeStringLiteral(value, literal);
+
+        EXPECT_EQ(value, unescapeStringLiteral(literal)) << literal;
+
+        // Parsed back as a single string literal.
+        const FunctionCall call = parseFunctionCall("f(" + literal + ")");
+        ASSERT_EQ(1u, call.parameters.size());
+        EXPECT_EQ(literal, call.parameters[0].value);
+    }
+
+    std::string output = "x=";
+    writeStringLiteral(R"(a"b\c)", output);
+    EXPECT_EQ(R"(x="a\"b\\c")", output);
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "InlineRingBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(InlineRingBufferTest, fifo)
+{
+    InlineRingBuffer<int, 4> buffer;
+    EXPECT_TRUE(buffer.empty());
+
+    // Wraps around the inline storage several times without growing.
+    for (int i = 0; i < 10; ++i)
+    {
+        buffer.push_back(i);
+        buffer.push_back(i + 100);
+        EXPECT_EQ(2u, buffer.size());
+
+        EXPECT_EQ(i, buffer.front());
+        buffer.pop_front();
+        EXPECT_EQ(i + 100, buffer.front());
+        buffer.pop_front();
+        EXPECT_TRUE(buffer.empty());
+    }
+}
+
+TEST(InlineRingBufferTest, spillToHeap)
+{
+    InlineRingBuffer<std::string, 2> buffer;
+    buffer.push_back("x");
+    buffer.pop_front();
+
+    // Head is in the middle of the inline storage when it grows.
+    for (int i = 0; i < 100; ++i)
+    {
+        buffer.push_back(std::to_string(i));
+    }
+    ASSERT_EQ(100u, buffer.size());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(std::to_string(i), buffer.front());
+        buffer.pop_front();
+    }
+    EXPECT_TRUE(buffer.empty());
+
+    buffer.push_back("y");
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+}
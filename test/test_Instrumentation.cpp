@@ -0,0 +1,73 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "Instrumentation.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace
+{
+
+InstrumentationCounters getDifference(const InstrumentationSnapshot& before, const InstrumentationSnapshot& after,
+        InstrumentationPoint point)
+{
+    const InstrumentationCounters& first = before.counters[point];
+    const InstrumentationCounters& second = after.counters[point];
+
+    return InstrumentationCounters{second.count - first.count, second.bytes - first.bytes,
+            second.nanoseconds - first.nanoseconds};
+}
+
+} // namespace
+
+TEST(InstrumentationTest, pointNames)
+{
+    EXPECT_STREQ("parse_function_call", getInstrumentationPointName(INSTRUMENTATION_PARSE_FUNCTION_CALL));
+    EXPECT_STREQ("unknown", getInstrumentationPointName(INSTRUMENTATION_POINT_COUNT));
+}
+
+TEST(InstrumentationTest, countersOfAllThreads)
+{
+    const std::string input = "f(1, b = \"x\")";
+    FunctionRegistry registry;
+    registry.addFunction("f(a, b, c = 3)");
+
+    const InstrumentationSnapshot before = getInstrumentationSnapshot();
+    registry.updateFunctionCall(parseFunctionCall(input));
+    // Counters of finished threads are kept.
+    std::thread([&input]()
+    {
+        parseFunctionCall(input);
+    }).join();
+    const InstrumentationSnapshot after = getInstrumentationSnapshot();
+
+    const InstrumentationCounters calls = getDifference(before, after, INSTRUMENTATION_PARSE_FUNCTION_CALL);
+    const InstrumentationCounters updates = getDifference(before, after, INSTRUMENTATION_UPDATE_FUNCTION_CALL);
+    const InstrumentationCounters lexemes = getDifference(before, after, INSTRUMENTATION_GET_NEXT_LEXEME);
+    const InstrumentationCounters tokens = getDifference(before, after, INSTRUMENTATION_GET_NEXT_TOKEN);
+    if (!isInstrumentationEnabled())
+    {
+        EXPECT_EQ(0u, calls.count);
+        EXPECT_EQ(0u, lexemes.count);
+        EXPECT_EQ(0u, after.counters[INSTRUMENTATION_GET_NEXT_TOKEN].count);
+        return;
+    }
+
+    EXPECT_EQ(2u, calls.count);
+    EXPECT_EQ(2 * input.size(), calls.bytes);
+    EXPECT_EQ(1u, updates.count);
+    EXPECT_EQ(0u, updates.bytes);
+    // "f", "(", "1", ",", "b", "=", "\"x\"", ")" and the end of input.
+    EXPECT_EQ(2 * 9u, lexemes.count);
+    // Whitespace is a token, but not a part of any lexeme.
+    EXPECT_EQ(2 * (input.size() - 3), lexemes.bytes);
+    EXPECT_EQ(2 * input.size(), tokens.bytes);
+    EXPECT_LE(lexemes.count, tokens.count);
+}
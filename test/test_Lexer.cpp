@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <ostream>
+#include <string>
 #include <vector>
 
 static const Lexeme EofLexeme{std::string(), LEX_END_OF_INPUT};
@@ -121,3 +122,105 @@ INSTANTIATE_TEST_CASE_P(
         Compound, LexerTest,
         ::testing::ValuesIn(LexCompoundTestCases),
 );
+
+#define ERROR_LEXEME_TEST_CASE(input)     {input, {Lexeme{"", LEX_ERROR}}}
+
+const LexerTestCase LexErrorTestCases[] =
+{
+    ERROR_LEXEME_TEST_CASE("1.2.3"),
+    ERROR_LEXEME_TEST_CASE("1."),
+    ERROR_LEXEME_TEST_CASE("123abc"),
+    ERROR_LEXEME_TEST_CASE("abc.def"),
+    ERROR_LEXEME_TEST_CASE(".5"),
+    {
+        // error is sticky
+        "abc 1.2.3 def",
+        {
+            Lexeme{"abc", LEX_NAME},
+            Lexeme{"", LEX_ERROR},
+            Lexeme{"", LEX_ERROR},
+        }
+    },
+};
+
+INSTANTIATE_TEST_CASE_P(
+        Error, LexerTest,
+        ::testing::ValuesIn(LexErrorTestCases),
+);
+
+TEST(LexerTest, errorOffsetAndCode)
+{
+    Lexer lexer("abc 1.2.3");
+
+    EXPECT_EQ(0u, lexer.getNextLexeme().offset);
+
+    const Lexeme lexeme = lexer.getNextLexeme();
+    EXPECT_EQ(LEX_ERROR, lexeme.type);
+    EXPECT_EQ(7u, lexeme.offset);
+    EXPECT_EQ(PARSE_ERROR_INVALID_NUMBER, lexer.getError());
+}
+
+TEST(LexerTest, manyTokensInLexeme)
+{
+    // Name of alternating letters and digits is a token per character,
+    // more than the Lexer keeps inline.
+    std::string name;
+    for (int i = 0; i < 100; ++i)
+    {
+        name += "a1";
+    }
+    const std::string input = name + " (";
+    Lexer lexer(input);
+
+    const Lexeme lexeme = lexer.getNextLexeme();
+    EXPECT_EQ(LEX_NAME, lexeme.type);
+    EXPECT_EQ(name, lexeme.value);
+    EXPECT_EQ(LEX_LEFT_PARENTHESIS, lexer.getNextLexeme().type);
+    EXPECT_EQ(LEX_END_OF_INPUT, lexer.getNextLexeme().type);
+}
+
+TEST(LexerTest, unterminatedString)
+{
+    Lexer lexer("f(\"abc");
+
+    EXPECT_EQ(LEX_NAME, lexer.getNextLexeme().type);
+    EXPECT_EQ(LEX_LEFT_PARENTHESIS, lexer.getNextLexeme().type);
+
+    // Used to be an endless sequence of empty string literals.
+    const Lexeme lexeme = lexer.getNextLexeme();
+    EXPECT_EQ(LEX_ERROR, lexeme.type);
+    EXPECT_EQ(2u, lexeme.offset);
+    EXPECT_EQ(PARSE_ERROR_UNTERMINATED_STRING, lexer.getError());
+    EXPECT_EQ(LEX_ERROR, lexer.getNextLexeme().type);
+}
+
+TEST(LexerTest, limits)
+{
+    const ParseLimits limits{16, 4, 5};
+    {
+        Lexer lexer("f(1, 2, 3, 4, 5, 6)", limits);
+        const Lexeme lexeme = lexer.getNextLexeme();
+        EXPECT_EQ(LEX_ERROR, lexeme.type);
+        EXPECT_EQ(16u, lexeme.offset);
+        EXPECT_EQ(PARSE_ERROR_INPUT_TOO_LONG, lexer.getError());
+    }
+    {
+        Lexer lexer("f(1, 2)", limits);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_NE(LEX_ERROR, lexer.getNextLexeme().type);
+        }
+        const Lexeme lexeme = lexer.getNextLexeme();
+        EXPECT_EQ(LEX_ERROR, lexeme.type);
+        EXPECT_EQ(5u, lexeme.offset);
+        EXPECT_EQ(PARSE_ERROR_TOO_MANY_LEXEMES, lexer.getError());
+    }
+    {
+        Lexer lexer("12345 \"abcd\"", limits);
+        EXPECT_EQ(LEX_NUMBER_LITERAL, lexer.getNextLexeme().type);
+        const Lexeme lexeme = lexer.getNextLexeme();
+        EXPECT_EQ(LEX_ERROR, lexeme.type);
+        EXPECT_EQ(6u, lexeme.offset);
+        EXPECT_EQ(PARSE_ERROR_LITERAL_TOO_LONG, lexer.getError());
+    }
+}
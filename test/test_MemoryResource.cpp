@@ -0,0 +1,224 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "MemoryResource.h"
+#include "AllocationCounter.h"
+#include "FunctionParser.h"
+#include "FunctionRegistry.h"
+#include "ParserContext.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// Forwards to the default resource, counting allocations that are not returned yet.
+class CountingMemoryResource : public MemoryResource
+{
+public:
+    CountingMemoryResource()
+        : allocations(0),
+          liveAllocations(0)
+    {}
+
+    size_t allocations;
+    size_t liveAllocations;
+
+protected:
+    void* doAllocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        ++liveAllocations;
+        return getDefaultMemoryResource()->allocate(bytes, alignment);
+    }
+
+    void doDeallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        --liveAllocations;
+        getDefaultMemoryResource()->deallocate(p, bytes, alignment);
+    }
+
+    bool doIsEqual(const MemoryResource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+bool isAligned(const void* p, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(MemoryResourceTest, monotonicGrowsAndReleases)
+{
+    CountingMemoryResource upstream;
+    MonotonicMemoryResource resource(256, &upstream);
+
+    char* previous = nullptr;
+    for (size_t i = 1; i < 100; ++i)
+    {
+        char* p = static_cast<char*>(resource.allocate(i, 8));
+        EXPECT_TRUE(isAligned(p, 8));
+        EXPECT_NE(previous, p);
+        previous = p;
+        resource.deallocate(p, i, 8);
+    }
+    const size_t blockCount = upstream.liveAllocations;
+    // Blocks double in size.
+    EXPECT_LT(1u, blockCount);
+    EXPECT_GT(8u, blockCount);
+
+    // Bigger than any block.
+    EXPECT_NE(nullptr, resource.allocate(100000));
+    EXPECT_EQ(blockCount + 1, upstream.liveAllocations);
+
+    resource.release();
+    EXPECT_EQ(0u, upstream.liveAllocations);
+    EXPECT_NE(nullptr, resource.allocate(0));
+}
+
+TEST(MemoryResourceTest, monotonicUsesBufferFirst)
+{
+    CountingMemoryResource upstream;
+    alignas(std::max_align_t) char buffer[128];
+    MonotonicMemoryResource resource(buffer, sizeof(buffer), &upstream);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const char* first = static_cast<const char*>(resource.allocate(100, 1));
+        EXPECT_EQ(buffer, first);
+        EXPECT_EQ(0u, upstream.allocations);
+
+        resource.allocate(100, 1);
+        EXPECT_EQ(1u, upstream.liveAllocations);
+
+        // Buffer is reused after release.
+        resource.release();
+        upstream.allocations = 0;
+    }
+}
+
+TEST(MemoryResourceTest, standardContainer)
+{
+    CountingMemoryResource resource;
+    {
+        std::vector<std::string, ResourceAllocator<std::string>> strings{ResourceAllocator<std::string>(&resource)};
+        strings.resize(10);
+        EXPECT_EQ(&resource, strings.get_allocator().getResource());
+        EXPECT_LT(0u, resource.liveAllocations);
+
+        // Copy doesn't keep the resource.
+        const auto copy(strings);
+        EXPECT_EQ(getDefaultMemoryResource(), copy.get_allocator().getResource());
+    }
+    EXPECT_EQ(0u, resource.liveAllocations);
+}
+
+TEST(MemoryResourceTest, smallVector)
+{
+    typedef SmallVector<int, 2, ResourceAllocator<int>> Vector;
+    CountingMemoryResource resource;
+    {
+        Vector vector{{1, 2}, ResourceAllocator<int>(&resource)};
+        EXPECT_EQ(0u, resource.allocations);
+        vector.push_back(3);
+        EXPECT_EQ(1u, resource.liveAllocations);
+
+        // Memory of a vector with other resource is not taken, elements are moved instead.
+        Vector other{1, 2, 3, 4, 5};
+        const int* otherData = other.data();
+        vector = std::move(other);
+        EXPECT_EQ(5u, vector.size());
+        EXPECT_NE(otherData, vector.data());
+        EXPECT_EQ(&resource, vector.get_allocator().getResource());
+
+        Vector copy(vector);
+        EXPECT_EQ(getDefaultMemoryResource(), copy.get_allocator().getResource());
+        EXPECT_EQ(vector, copy);
+    }
+    EXPECT_EQ(0u, resource.liveAllocations);
+}
+
+TEST(MemoryResourceTest, functionRegistry)
+{
+    CountingMemoryResource resource;
+    {
+        FunctionRegistry registry(&resource);
+        registry.addFunction("f(a, b, c, d, e, f, g = 1)");
+        registry.addFunction("g(a)");
+        const size_t allocations = resource.allocations;
+        EXPECT_LT(0u, allocations);
+
+        const RegisteredFunctionSpec* spec = registry.findFunctionSpecByName("f");
+        ASSERT_NE(nullptr, spec);
+        EXPECT_EQ(&resource, spec->parameters.get_allocator().getResource());
+
+        // Copies given out don't use registry's memory.
+        const FunctionSpec copy = registry.getFunctionSpecByName("f");
+        const FunctionCall call = registry.updateFunctionCall(parseFunctionCall("f(1, 2, 3, 4, 5, 6)"));
+        EXPECT_EQ(7u, call.parameters.size());
+        EXPECT_EQ(allocations, resource.allocations);
+    }
+    EXPECT_EQ(0u, resource.liveAllocations);
+}
+
+TEST(MemoryResourceTest, functionRegistryStrings)
+{
+    alignas(std::max_align_t) char buffer[16384];
+    CountingMemoryResource upstream;
+    MonotonicMemoryResource resource(buffer, sizeof(buffer), &upstream);
+    FunctionRegistry registry(&resource);
+
+    // Parameter names and values are too long for small string buffer, function name
+    // is short, since it is returned by addFunction().
+    const std::string longName(100, 'x');
+    const FunctionSpec spec = parseFunctionSpec("f(a_" + longName + ", b = \"" + longName + "\")");
+    {
+        AllocationScope allocations;
+        registry.addFunction(spec);
+        EXPECT_EQ(0u, allocations.getCount());
+    }
+    EXPECT_EQ(0u, upstream.allocations);
+
+    const RegisteredFunctionSpec* registered = registry.findFunctionSpecByName(spec.name);
+    ASSERT_NE(nullptr, registered);
+    ASSERT_EQ(2u, registered->parameters.size());
+    ASSERT_TRUE(static_cast<bool>(registered->parameters[1].value));
+    const std::less<const char*> isLess;
+    const char* value = registered->parameters[1].value->data();
+    EXPECT_FALSE(isLess(value, buffer) || isLess(buffer + sizeof(buffer) - 1, value));
+    EXPECT_EQ(spec.parameters[1].value, registered->parameters[1].value->to_string());
+
+    // Copies given out are the same as the spec added.
+    const FunctionSpec copy = registry.getFunctionSpecByName(spec.name);
+    EXPECT_EQ(spec.name, copy.name);
+    ASSERT_EQ(2u, copy.parameters.size());
+    EXPECT_EQ(spec.parameters[0].name, copy.parameters[0].name);
+    EXPECT_FALSE(copy.parameters[0].value);
+    EXPECT_EQ(spec.parameters[1].value, copy.parameters[1].value);
+    EXPECT_EQ(getDefaultMemoryResource(), copy.parameters.get_allocator().getResource());
+}
+
+TEST(MemoryResourceTest, parseIntoArena)
+{
+    CountingMemoryResource upstream;
+    MonotonicMemoryResource arena(1024, &upstream);
+    FunctionCall call{std::string(), FunctionCallParameters(&arena), InvalidSymbolId};
+
+    ParserContext context;
+    context.reset("f(1, 2, 3, 4, 5, 6, 7, 8)");
+    ASSERT_EQ(PARSE_ERROR_NONE, context.parseCall(call).code);
+    EXPECT_EQ(8u, call.parameters.size());
+    EXPECT_EQ(&arena, call.parameters.get_allocator().getResource());
+    EXPECT_EQ(1u, upstream.allocations);
+}
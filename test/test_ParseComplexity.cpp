@@ -0,0 +1,149 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "FunctionParser.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <random>
+#include <string>
+
+// Parse time of adversarial inputs must grow linearly with their size.
+// Built as a separate target, since it takes a while and measures time.
+
+namespace
+{
+
+struct AdversarialInput
+{
+    const char* name;
+    std::function<std::string (size_t size)> generate;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const AdversarialInput& input)
+{
+    return ostr << input.name;
+}
+
+std::string repeat(const std::string& pattern, size_t size)
+{
+    std::string result;
+    result.reserve(size + pattern.size());
+    while (result.size() < size)
+    {
+        result += pattern;
+    }
+
+    return result;
+}
+
+const AdversarialInput AdversarialInputs[] =
+{
+    {"unterminatedString", [](size_t size) { return "f(\"" + repeat("a", size); }},
+    {"unterminatedEscapes", [](size_t size) { return "f(\"" + repeat("\\", size); }},
+    {"manyStrings", [](size_t size) { return "f(" + repeat("\"\",", size) + "1)"; }},
+    {"manyArguments", [](size_t size) { return "f(" + repeat("1,", size) + "1)"; }},
+    {"manyNamedArguments", [](size_t size) { return "f(" + repeat("a=1,", size) + "a=1)"; }},
+    {"longExpression", [](size_t size) { return "f(" + repeat("1+a(", size); }},
+    {"foldedExpression", [](size_t size) { return "f(" + repeat("1+2*", size) + "3)"; }},
+    {"deepNesting", [](size_t size) { return "f(" + repeat("(", size); }},
+    {"unaryMinus", [](size_t size) { return "f(" + repeat("-", size) + "1)"; }},
+    {"tokenPerCharacterName", [](size_t size) { return repeat("a1", size) + "()"; }},
+    {"longNumber", [](size_t size) { return "f(" + repeat("1", size) + ")"; }},
+    {"dots", [](size_t size) { return "f(1" + repeat(".", size) + ")"; }},
+    {"whitespace", [](size_t size) { return "f(" + repeat(" \t", size) + ")"; }},
+    {"spec", [](size_t size) { return "f(" + repeat("a=\"x\",", size) + "b)"; }},
+};
+
+/// Best of several runs, nanoseconds per byte of input.
+double measureParseTime(const std::string& input)
+{
+    double best = 0;
+    for (int run = 0; run < 5; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const bool callParsed = static_cast<bool>(tryParseFunctionCall(input));
+        const bool specParsed = static_cast<bool>(tryParseFunctionSpec(input));
+        const auto finish = std::chrono::steady_clock::now();
+        // Results are used, so that calls are not optimized out.
+        EXPECT_LE(int(callParsed) + int(specParsed), 2);
+
+        const double time = std::chrono::duration<double, std::nano>(finish - start).count();
+        best = run == 0 ? time : std::min(best, time);
+    }
+
+    return best / input.size();
+}
+
+} // namespace
+
+class ParseComplexityTest : public ::testing::TestWithParam<AdversarialInput>
+{};
+
+TEST_P(ParseComplexityTest, linearTime)
+{
+    const size_t SmallSize = 16 * 1024;
+    const size_t LargeSize = 256 * 1024;
+    // Quadratic parse would be 16 times slower per byte on the large input.
+    const double MaxSlowdown = 4;
+    // Way above any sane machine, catches something much worse than quadratic.
+    const double MaxTimePerByte = 5000;
+
+    const std::string small = GetParam().generate(SmallSize);
+    const std::string large = GetParam().generate(LargeSize);
+
+    // Warm up.
+    measureParseTime(small);
+
+    const double smallTime = measureParseTime(small);
+    const double largeTime = measureParseTime(large);
+    EXPECT_LT(largeTime, smallTime * MaxSlowdown + 1)
+            << "ns per byte: " << smallTime << " on " << small.size() << " bytes, "
+            << largeTime << " on " << large.size() << " bytes";
+    EXPECT_LT(largeTime, MaxTimePerByte);
+}
+
+INSTANTIATE_TEST_CASE_P(
+        Adversarial, ParseComplexityTest,
+        ::testing::ValuesIn(AdversarialInputs),
+);
+
+TEST(ParseComplexityTest, inputOverLimitIsNotRead)
+{
+    const std::string input = "f(" + std::string(DefaultParseLimits.maxInputLength, '1') + ")";
+
+    const ParseResult<FunctionCall> result = tryParseFunctionCall(input);
+    ASSERT_FALSE(result);
+    EXPECT_EQ((ParseError{PARSE_ERROR_INPUT_TOO_LONG, DefaultParseLimits.maxInputLength}), result.getError());
+}
+
+TEST(ParseComplexityTest, randomInputs)
+{
+    const char Alphabet[] = "fab1290(),=\"\\.+-*/? \t";
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<size_t> length(0, 64);
+    std::uniform_int_distribution<size_t> character(0, sizeof(Alphabet) - 2);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::string input(length(random), ' ');
+        for (char& c : input)
+        {
+            c = Alphabet[character(random)];
+        }
+
+        // Every input is parsed, errors point into the input.
+        const ParseResult<FunctionCall> call = tryParseFunctionCall(input);
+        ASSERT_LE(call.getError().offset, input.size()) << input;
+        const ParseResult<FunctionSpec> spec = tryParseFunctionSpec(input);
+        ASSERT_LE(spec.getError().offset, input.size()) << input;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ParsedCallCache.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(ParsedCallCacheTest, hitAndMiss)
+{
+    ParsedCallCache cache(1024 * 1024);
+
+    const auto first = cache.parse("f(1, b=2)");
+    ASSERT_TRUE(first);
+    EXPECT_EQ(parseFunctionCall("f(1, b=2)"), *first.getValue());
+    EXPECT_EQ(0u, cache.getHits());
+    EXPECT_EQ(1u, cache.getMisses());
+
+    // Input is copied, so cache doesn't depend on the lifetime of the original.
+    const std::string input = "f(1, b=2)";
+    const auto second = cache.parse(input);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(first.getValue(), second.getValue());
+    EXPECT_EQ(1u, cache.getHits());
+    EXPECT_EQ(1u, cache.getMisses());
+    EXPECT_EQ(1u, cache.getSize());
+
+    // Whitespace matters, since key is the exact text.
+    EXPECT_TRUE(cache.parse("f(1, b=2) "));
+    EXPECT_EQ(2u, cache.getMisses());
+    EXPECT_EQ(2u, cache.getSize());
+}
+
+TEST(ParsedCallCacheTest, errorsAreNotCached)
+{
+    ParsedCallCache cache(1024 * 1024);
+
+    const auto result = cache.parse("f(1,)");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(PARSE_ERROR_EXPECTED_VALUE, result.getError().code);
+    EXPECT_EQ(0u, cache.getSize());
+
+    EXPECT_FALSE(cache.parse("f(1,)"));
+    EXPECT_EQ(0u, cache.getHits());
+    EXPECT_EQ(2u, cache.getMisses());
+}
+
+TEST(ParsedCallCacheTest, evictsLeastRecentlyUsed)
+{
+    ParsedCallCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.parse("a()"));
+    const size_t entryMemoryUsage = cache.getMemoryUsage();
+    ASSERT_LT(0u, entryMemoryUsage);
+
+    // Room for about two entries of the same size.
+    ParsedCallCache smallCache(entryMemoryUsage * 2 + entryMemoryUsage / 2);
+    smallCache.parse("a()");
+    smallCache.parse("b()");
+    smallCache.parse("a()"); // b() is least recently used now.
+    smallCache.parse("c()");
+
+    EXPECT_EQ(2u, smallCache.getSize());
+    EXPECT_GE(entryMemoryUsage * 2 + entryMemoryUsage / 2, smallCache.getMemoryUsage());
+
+    const size_t hits = smallCache.getHits();
+    smallCache.parse("a()");
+    smallCache.parse("c()");
+    EXPECT_EQ(hits + 2, smallCache.getHits());
+
+    smallCache.parse("b()");
+    EXPECT_EQ(hits + 2, smallCache.getHits());
+}
+
+TEST(ParsedCallCacheTest, entryLargerThanLimit)
+{
+    ParsedCallCache cache(16);
+
+    EXPECT_TRUE(cache.parse("a()"));
+    EXPECT_EQ(0u, cache.getSize());
+    EXPECT_EQ(0u, cache.getMemoryUsage());
+}
+
+TEST(ParsedCallCacheTest, clear)
+{
+    ParsedCallCache cache(1024 * 1024);
+    const auto call = cache.parse("a()");
+    cache.clear();
+
+    EXPECT_EQ(0u, cache.getSize());
+    EXPECT_EQ(0u, cache.getMemoryUsage());
+    // Calls handed out before are still valid.
+    EXPECT_EQ("a", call.getValue()->name);
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ParserContext.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(ParserContextTest, parseCallSequence)
+{
+    // Shapes change between inputs: more and fewer parameters, named and positional.
+    const std::vector<std::string> inputs =
+    {
+        R"(f(1, b="foo", c=2 * g()))",
+        "g()",
+        R"(function(1, 2.5, c=3, d="foobar", e=h(1) + 2))",
+        "f(x=1)",
+        "f(1 +",
+        R"(f("a", 1))",
+    };
+
+    ParserContext context;
+    FunctionCall call;
+    for (const auto& input : inputs)
+    {
+        const ParseResult<FunctionCall> expected = tryParseFunctionCall(input);
+
+        context.reset(input);
+        const ParseError error = context.parseCall(call);
+        EXPECT_EQ(expected.getError(), error) << input;
+        if (expected)
+        {
+            EXPECT_EQ(expected.getValue(), call) << input;
+        }
+    }
+}
+
+TEST(ParserContextTest, parseCallReusesMemory)
+{
+    const std::string first = R"(first(1, name="a string that doesn't fit into SSO buffer", c=(1 + f())))";
+    const std::string second = R"(other(2, name="another string, no longer than the first", c=(2 * g())))";
+
+    ParserContext context;
+    FunctionCall call;
+    context.reset(first);
+    ASSERT_EQ((ParseError{PARSE_ERROR_NONE, 0}), context.parseCall(call));
+
+    const FunctionCallParameter* parameters = call.parameters.data();
+    const char* value = call.parameters[1].value.data();
+    const char* name = call.parameters[1].name->data();
+
+    context.reset(second);
+    ASSERT_EQ((ParseError{PARSE_ERROR_NONE, 0}), context.parseCall(call));
+    EXPECT_EQ(parseFunctionCall(second), call);
+
+    EXPECT_EQ(parameters, call.parameters.data());
+    EXPECT_EQ(value, call.parameters[1].value.data());
+    EXPECT_EQ(name, call.parameters[1].name->data());
+}
+
+TEST(ParserContextTest, parseSpec)
+{
+    SymbolTable symbols;
+    symbols.intern("f");
+    symbols.intern("b");
+
+    ParserContext context(&symbols);
+    FunctionSpec spec;
+    for (const char* input : {R"(f(a, b="x"))", "g(b=1, c)", "f()", "f(a=)"})
+    {
+        const ParseResult<FunctionSpec> expected = tryParseFunctionSpec(input, &symbols);
+
+        context.reset(input);
+        const ParseError error = context.parseSpec(spec);
+        EXPECT_EQ(expected.getError(), error) << input;
+        if (expected)
+        {
+            EXPECT_EQ(expected.getValue().name, spec.name);
+            EXPECT_EQ(expected.getValue().nameId, spec.nameId);
+            EXPECT_EQ(expected.getValue().parameters, spec.parameters);
+        }
+    }
+}
+
+TEST(ParserContextTest, parseNewCall)
+{
+    ParserContext context;
+    context.reset("f(1)");
+    const ParseResult<FunctionCall> result = context.parseCall();
+    ASSERT_TRUE(static_cast<bool>(result)) << result.getError();
+    EXPECT_EQ(parseFunctionCall("f(1)"), result.getValue());
+
+    context.reset("f(");
+    EXPECT_EQ((ParseError{PARSE_ERROR_EXPECTED_VALUE, 2}), context.parseCall().getError());
+}
+
+TEST(ParserContextTest, limits)
+{
+    ParserContext context(nullptr, ParseLimits{100, 100, 8});
+    context.reset(R"(f(a="short"))");
+    EXPECT_TRUE(static_cast<bool>(context.parseCall()));
+
+    FunctionSpec spec;
+    context.reset(R"(f(a="longer string"))");
+    EXPECT_EQ((ParseError{PARSE_ERROR_LITERAL_TOO_LONG, 4}), context.parseCall().getError());
+    EXPECT_EQ((ParseError{PARSE_ERROR_LITERAL_TOO_LONG, 4}), context.parseSpec(spec));
+}
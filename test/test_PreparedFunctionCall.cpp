@@ -0,0 +1,143 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "PreparedFunctionCall.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+FunctionRegistry makeTestRegistry()
+{
+    FunctionRegistry registry;
+    registry.addFunction(R"(f(a, b, c="default", d=1))");
+    registry.addFunction("g()");
+
+    return registry;
+}
+
+struct PreparedFunctionCallErrorTestCase
+{
+    const char* callTemplate;
+    const ParseError error;
+};
+
+std::ostream& operator<<(std::ostream& ostr, const PreparedFunctionCallErrorTestCase& testCase)
+{
+    return ostr << "PreparedFunctionCallErrorTestCase{" << testCase.callTemplate << ", " << testCase.error << "}";
+}
+
+class PreparedFunctionCallErrorTest : public ::testing::TestWithParam<PreparedFunctionCallErrorTestCase>
+{};
+
+} // namespace
+
+TEST(PreparedFunctionCallTest, bind)
+{
+    const FunctionRegistry registry = makeTestRegistry();
+    const auto prepared = prepareFunctionCall(R"(f(b=?, a=?, c="fixed"))", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+    ASSERT_EQ(2u, prepared.getValue().getPlaceholderCount());
+
+    const FunctionCall call = prepared.getValue().bind({"1", R"("foo")"});
+    const FunctionCall expected = registry.updateFunctionCall(
+            parseFunctionCall(R"(f(a="foo", b=1, c="fixed"))", &registry.getSymbolTable()));
+    EXPECT_EQ(expected, call);
+}
+
+TEST(PreparedFunctionCallTest, positionalAndExpressions)
+{
+    const FunctionRegistry registry = makeTestRegistry();
+    const auto prepared = prepareFunctionCall("f(?, g() + 1, d = ?)", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+
+    const FunctionCall call = prepared.getValue().bind({"1.5", "-2"});
+    ASSERT_EQ(4u, call.parameters.size());
+    EXPECT_EQ("1.5", call.parameters[0].value);
+    EXPECT_EQ(CALL_VALUE_NUMBER, call.parameters[0].valueType);
+    EXPECT_EQ("g() + 1", call.parameters[1].value);
+    EXPECT_EQ(CALL_VALUE_EXPRESSION, call.parameters[1].valueType);
+    EXPECT_EQ(R"("default")", call.parameters[2].value);
+    EXPECT_EQ(CALL_VALUE_STRING, call.parameters[2].valueType);
+    EXPECT_EQ("-2", call.parameters[3].value);
+    EXPECT_EQ(CALL_VALUE_NUMBER, call.parameters[3].valueType);
+    EXPECT_EQ(std::string("d"), call.parameters[3].name);
+    EXPECT_EQ(registry.getSymbolTable().find("d"), call.parameters[3].nameId);
+}
+
+TEST(PreparedFunctionCallTest, bindReusesCall)
+{
+    const FunctionRegistry registry = makeTestRegistry();
+    const auto prepared = prepareFunctionCall("f(?, ?)", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+
+    FunctionCall call;
+    for (int i = 0; i < 3; ++i)
+    {
+        const std::string values[] = {std::to_string(i), std::to_string(i * 2)};
+        prepared.getValue().bind(values, 2, call);
+        EXPECT_EQ(std::to_string(i), call.parameters[0].value);
+        EXPECT_EQ(std::to_string(i * 2), call.parameters[1].value);
+        EXPECT_EQ("1", call.parameters[3].value);
+    }
+}
+
+TEST(PreparedFunctionCallTest, noPlaceholders)
+{
+    const FunctionRegistry registry = makeTestRegistry();
+    const auto prepared = prepareFunctionCall("g()", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+
+    EXPECT_EQ(0u, prepared.getValue().getPlaceholderCount());
+    EXPECT_EQ("g", prepared.getValue().bind({}).name);
+}
+
+TEST(PreparedFunctionCallTest, wrongValueCount)
+{
+    const FunctionRegistry registry = makeTestRegistry();
+    const auto prepared = prepareFunctionCall("f(?, ?)", registry);
+    ASSERT_TRUE(static_cast<bool>(prepared)) << prepared.getError();
+
+    EXPECT_THROW(prepared.getValue().bind({"1"}), std::invalid_argument);
+    EXPECT_THROW(prepared.getValue().bind({"1", "2", "3"}), std::invalid_argument);
+}
+
+TEST(PreparedFunctionCallTest, placeholdersAreNotValues)
+{
+    EXPECT_EQ((ParseError{PARSE_ERROR_EXPECTED_VALUE, 2}), tryParseFunctionCall("f(?)").getError());
+}
+
+TEST_P(PreparedFunctionCallErrorTest, prepareFunctionCall)
+{
+    const PreparedFunctionCallErrorTestCase& testCase = GetParam();
+    const FunctionRegistry registry = makeTestRegistry();
+
+    EXPECT_EQ(testCase.error, prepareFunctionCall(testCase.callTemplate, registry).getError());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Errors,
+    PreparedFunctionCallErrorTest,
+    ::testing::ValuesIn(std::vector<PreparedFunctionCallErrorTestCase>{
+        {"h(?)",                {PARSE_ERROR_UNKNOWN_FUNCTION, 0}},
+        {"f(?, e=?)",           {PARSE_ERROR_UNKNOWN_PARAMETER, 5}},
+        {"f(?, a=?)",           {PARSE_ERROR_DUPLICATE_PARAMETER, 5}},
+        {"f(?, ?, ?, ?, ?)",    {PARSE_ERROR_TOO_MANY_PARAMETERS, 14}},
+        {"f(a=?)",              {PARSE_ERROR_MISSING_PARAMETER, 6}},
+        {"f(?, ? + 1)",         {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 7}},
+        {"f(?, 1 + ?)",         {PARSE_ERROR_EXPECTED_VALUE, 9}},
+        {"f(?, ?\?)",           {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 6}},
+        {"f(?",                 {PARSE_ERROR_EXPECTED_COMMA_OR_RIGHT_PARENTHESIS, 3}},
+        {"f(a=?, ?)",           {PARSE_ERROR_POSITIONAL_AFTER_NAMED, 7}},
+    }),
+);
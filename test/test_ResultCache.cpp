@@ -0,0 +1,59 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ResultCache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+TEST(ResultCacheTest, keys)
+{
+    std::string first;
+    std::string second;
+
+    makeResultCacheKey(first, std::make_tuple(std::string("ab"), std::string("c")));
+    makeResultCacheKey(second, std::make_tuple(std::string("a"), std::string("bc")));
+    EXPECT_NE(first, second);
+
+    makeResultCacheKey(first, std::make_tuple(int64_t(1), 2.5, boost::string_view("foo")));
+    makeResultCacheKey(second, std::make_tuple(int64_t(1), 2.5, std::string("foo")));
+    EXPECT_EQ(first, second);
+}
+
+TEST(ResultCacheTest, findAndInsert)
+{
+    ResultCache<int> cache(2);
+    int result = 0;
+
+    EXPECT_FALSE(cache.find("a", result));
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    EXPECT_TRUE(cache.find("a", result));
+    EXPECT_EQ(1, result);
+
+    // "b" is least recently used.
+    cache.insert("c", 3);
+    EXPECT_FALSE(cache.find("b", result));
+    EXPECT_TRUE(cache.find("c", result));
+    EXPECT_EQ(3, result);
+
+    const ResultCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(2u, statistics.hits);
+    EXPECT_EQ(2u, statistics.misses);
+    EXPECT_EQ(2u, statistics.size);
+}
+
+TEST(ResultCacheTest, zeroSize)
+{
+    ResultCache<int> cache(0);
+    int result = 0;
+
+    cache.insert("a", 1);
+    EXPECT_FALSE(cache.find("a", result));
+    EXPECT_EQ(0u, cache.getStatistics().size);
+}
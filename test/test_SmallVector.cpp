@@ -0,0 +1,202 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "SmallVector.h"
+#include "FunctionParser.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(SmallVectorTest, growsFromInlineToHeap)
+{
+    SmallVector<std::string, 2> vector;
+    EXPECT_TRUE(vector.empty());
+    EXPECT_TRUE(vector.isInline());
+
+    vector.push_back("a");
+    vector.emplace_back("b");
+    EXPECT_TRUE(vector.isInline());
+    EXPECT_EQ(2u, vector.size());
+
+    vector.push_back("c");
+    EXPECT_FALSE(vector.isInline());
+    ASSERT_EQ(3u, vector.size());
+    EXPECT_EQ("a", vector[0]);
+    EXPECT_EQ("b", vector[1]);
+    EXPECT_EQ("c", vector.back());
+
+    vector.pop_back();
+    vector.clear();
+    EXPECT_TRUE(vector.empty());
+}
+
+TEST(SmallVectorTest, pushBackOwnElement)
+{
+    SmallVector<std::string, 2> vector{"first element, too long for SSO", "b"};
+
+    // Argument refers to the element that is moved when vector grows.
+    vector.push_back(vector[0]);
+    ASSERT_EQ(3u, vector.size());
+    EXPECT_EQ(vector[0], vector[2]);
+
+    vector.resize(10, vector[1]);
+    ASSERT_EQ(10u, vector.size());
+    EXPECT_EQ("b", vector[9]);
+}
+
+TEST(SmallVectorTest, copyAssignmentReusesElements)
+{
+    const SmallVector<std::string, 2> source{"long enough string to be on heap", "another long string on heap"};
+    SmallVector<std::string, 2> target{"old value which is long, on heap", "and the other one, also long"};
+    const char* firstData = target[0].data();
+
+    target = source;
+    EXPECT_EQ(source, target);
+    EXPECT_EQ(firstData, target[0].data());
+
+    SmallVector<std::string, 2> copy(source);
+    EXPECT_EQ(source, copy);
+    copy.push_back("c");
+    EXPECT_NE(source, copy);
+}
+
+TEST(SmallVectorTest, move)
+{
+    SmallVector<std::string, 2> inlineSource{"a"};
+    SmallVector<std::string, 2> inlineTarget(std::move(inlineSource));
+    ASSERT_EQ(1u, inlineTarget.size());
+    EXPECT_EQ("a", inlineTarget[0]);
+    EXPECT_TRUE(inlineSource.empty());
+
+    SmallVector<std::string, 2> heapSource{"a", "b", "c"};
+    const std::string* heapData = heapSource.data();
+    SmallVector<std::string, 2> heapTarget{"x"};
+    heapTarget = std::move(heapSource);
+    EXPECT_EQ(heapData, heapTarget.data());
+    EXPECT_EQ(3u, heapTarget.size());
+    EXPECT_TRUE(heapSource.empty());
+    EXPECT_TRUE(heapSource.isInline());
+
+    heapTarget = std::move(inlineTarget);
+    ASSERT_EQ(1u, heapTarget.size());
+    EXPECT_EQ("a", heapTarget[0]);
+}
+
+TEST(SmallVectorTest, resizeAndAt)
+{
+    SmallVector<int, 4> vector;
+    vector.resize(3);
+    EXPECT_EQ(0, vector.at(2));
+    EXPECT_THROW(vector.at(3), std::out_of_range);
+
+    vector.resize(6, 7);
+    EXPECT_EQ(7, vector.at(5));
+    vector.resize(1);
+    EXPECT_EQ(1u, vector.size());
+    EXPECT_EQ(6u, vector.capacity());
+}
+
+TEST(SmallVectorTest, parametersOfTypicalCallAreInline)
+{
+    const FunctionCall call = parseFunctionCall("f(1, 2, 3, a = 4)");
+    EXPECT_TRUE(call.parameters.isInline());
+
+    const FunctionSpec spec = parseFunctionSpec("f(a, b, c = 1, d = \"x\", e, f = 2, g)");
+    EXPECT_FALSE(spec.parameters.isInline());
+    EXPECT_EQ("g", spec.parameters.back().name);
+}
+
+TEST(SmallVectorTest, insertAndEmplace)
+{
+    SmallVector<std::string, 2> vector{"b"};
+    auto position = vector.insert(vector.begin(), "a");
+    EXPECT_EQ(vector.begin(), position);
+    position = vector.emplace(vector.end(), 2, 'c');
+    EXPECT_EQ("cc", *position);
+    EXPECT_EQ((SmallVector<std::string, 2>{"a", "b", "cc"}), vector);
+
+    // Value refers to the element that is moved by insertion.
+    vector.insert(vector.begin() + 1, 2, vector[0]);
+    EXPECT_EQ((SmallVector<std::string, 2>{"a", "a", "a", "b", "cc"}), vector);
+
+    const std::vector<std::string> range{"x", "y"};
+    position = vector.insert(vector.begin() + 3, range.begin(), range.end());
+    EXPECT_EQ(vector.begin() + 3, position);
+    vector.insert(vector.end(), {"z"});
+    EXPECT_EQ((SmallVector<std::string, 2>{"a", "a", "a", "x", "y", "b", "cc", "z"}), vector);
+
+    SmallVector<int, 4> numbers;
+    // Two ints are count and value rather than a range.
+    numbers.insert(numbers.end(), 3, 7);
+    EXPECT_EQ((SmallVector<int, 4>{7, 7, 7}), numbers);
+}
+
+TEST(SmallVectorTest, erase)
+{
+    SmallVector<std::string, 2> vector{"a", "b", "c", "d", "e"};
+    auto position = vector.erase(vector.begin() + 1);
+    EXPECT_EQ("c", *position);
+    position = vector.erase(vector.begin() + 2, vector.end());
+    EXPECT_EQ(vector.end(), position);
+    EXPECT_EQ((SmallVector<std::string, 2>{"a", "c"}), vector);
+
+    position = vector.erase(vector.begin(), vector.begin());
+    EXPECT_EQ(vector.begin(), position);
+    EXPECT_EQ(2u, vector.size());
+}
+
+TEST(SmallVectorTest, assign)
+{
+    SmallVector<std::string, 2> vector{"old value which is long, on heap", "b", "c"};
+    const char* firstData = vector[0].data();
+
+    const std::vector<std::string> values{"new value which is long, on heap", "x"};
+    vector.assign(values.begin(), values.end());
+    EXPECT_EQ(values, vector.toVector());
+    EXPECT_EQ(firstData, vector[0].data());
+
+    vector.assign(3, vector[1]);
+    EXPECT_EQ((SmallVector<std::string, 2>{"x", "x", "x"}), vector);
+    vector.assign(5, vector[0]);
+    EXPECT_EQ((SmallVector<std::string, 2>(5, "x")), vector);
+
+    vector = {"p", "q"};
+    EXPECT_EQ((SmallVector<std::string, 2>{"p", "q"}), vector);
+    vector.assign({});
+    EXPECT_TRUE(vector.empty());
+}
+
+TEST(SmallVectorTest, swap)
+{
+    SmallVector<std::string, 2> inlineVector{"a"};
+    SmallVector<std::string, 2> heapVector{"x", "y", "z"};
+    const std::string* heapData = heapVector.data();
+
+    swap(inlineVector, heapVector);
+    EXPECT_EQ((SmallVector<std::string, 2>{"x", "y", "z"}), inlineVector);
+    EXPECT_EQ(heapData, inlineVector.data());
+    EXPECT_EQ((SmallVector<std::string, 2>{"a"}), heapVector);
+    EXPECT_TRUE(heapVector.isInline());
+
+    SmallVector<std::string, 2> other{"b", "c"};
+    other.swap(heapVector);
+    EXPECT_EQ((SmallVector<std::string, 2>{"b", "c"}), heapVector);
+    EXPECT_EQ((SmallVector<std::string, 2>{"a"}), other);
+}
+
+TEST(SmallVectorTest, reverseIteratorsAndConversions)
+{
+    const std::vector<int> values{1, 2, 3, 4, 5};
+    const SmallVector<int, 2> vector(values.begin(), values.end());
+    EXPECT_EQ(values, vector.toVector());
+
+    const std::vector<int> reversed(vector.rbegin(), vector.rend());
+    EXPECT_EQ((std::vector<int>{5, 4, 3, 2, 1}), reversed);
+    EXPECT_EQ(5, *vector.crbegin());
+    EXPECT_EQ(1, *(vector.crend() - 1));
+}
@@ -0,0 +1,138 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "StaticFunctionSpec.h"
+#include "FunctionRegistry.h"
+
+#include "Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace
+{
+
+constexpr StaticStringRef makeRef(const char* str)
+{
+    size_t size = 0;
+    while (str[size])
+    {
+        ++size;
+    }
+    return StaticStringRef(str, size);
+}
+
+// Parsed at compile time, checked at compile time.
+constexpr auto Spec = STATIC_FUNCTION_SPEC(R"( function(a, b , c = 1, d = "foo,\"bar") )");
+static_assert(Spec.name == makeRef("function"), "");
+static_assert(Spec.parameterCount == 4, "");
+static_assert(Spec.parameters[0].name == makeRef("a") && !Spec.parameters[0].hasValue, "");
+static_assert(Spec.parameters[1].name == makeRef("b") && !Spec.parameters[1].hasValue, "");
+static_assert(Spec.parameters[2].name == makeRef("c") && Spec.parameters[2].hasValue, "");
+static_assert(Spec.parameters[2].value == makeRef("1"), "");
+static_assert(Spec.parameters[3].value == makeRef(R"("foo,\"bar")"), "");
+
+constexpr auto EmptySpec = STATIC_FUNCTION_SPEC("f()");
+static_assert(EmptySpec.parameterCount == 0, "");
+
+constexpr auto NumberSpec = STATIC_FUNCTION_SPEC("f2(x=12.5)");
+static_assert(NumberSpec.name == makeRef("f2"), "");
+static_assert(NumberSpec.parameters[0].value == makeRef("12.5"), "");
+
+// Malformed specs are compile errors, e.g.:
+// constexpr auto BadSpec = STATIC_FUNCTION_SPEC("f(a,)");
+
+void expectSameAsRuntime(const FunctionSpec& expected, const FunctionSpec& actual)
+{
+    EXPECT_EQ(expected.name, actual.name);
+    ASSERT_EQ(expected.parameters.size(), actual.parameters.size());
+    for (size_t i = 0; i < expected.parameters.size(); ++i)
+    {
+        EXPECT_EQ(expected.parameters[i], actual.parameters[i]);
+    }
+}
+
+} // namespace
+
+TEST(StaticFunctionSpecTest, toFunctionSpec)
+{
+    expectSameAsRuntime(parseFunctionSpec(R"( function(a, b , c = 1, d = "foo,\"bar") )"),
+            Spec.toFunctionSpec());
+    expectSameAsRuntime(parseFunctionSpec("f()"), EmptySpec.toFunctionSpec());
+    expectSameAsRuntime(parseFunctionSpec("f2(x=12.5)"), NumberSpec.toFunctionSpec());
+}
+
+TEST(StaticFunctionSpecTest, addToRegistry)
+{
+    FunctionRegistry registry;
+    EXPECT_EQ("function", registry.addFunction(Spec));
+
+    const FunctionCall updated = registry.updateFunctionCall(parseFunctionCall("function(1, 2)"));
+    EXPECT_EQ(parseFunctionCall(R"(function(a=1, b=2, c=1, d="foo,\"bar"))"), updated);
+}
+
+// Both parsers run over the same specs, so that their grammars don't drift apart.
+// Static parser is run at run time here, the same inputs fail to compile in constant expressions.
+TEST(StaticFunctionSpecTest, sameGrammarAsRuntime)
+{
+    const char* const ValidSpecs[] =
+    {
+        "f()",
+        R"( function(a, b , c = 1, d = "foo,\"bar") )",
+        "f2(x=12.5)",
+        "f(a1, b_2=0, c3 = 007)",
+        "f(\ta\n=\r1\v,\fb)",
+        "f(a=\"\", b=\"[?]\", c=\"\\\\\")",
+        "f(a$, b@=1, c!)",
+    };
+
+    for (const char* spec : ValidSpecs)
+    {
+        const size_t size = std::char_traits<char>::length(spec);
+        const ParseResult<FunctionSpec> expected = tryParseFunctionSpec(spec);
+        ASSERT_TRUE(static_cast<bool>(expected)) << spec << ": " << expected.getError();
+        expectSameAsRuntime(expected.getValue(), parseStaticFunctionSpec<4>(spec, size).toFunctionSpec());
+    }
+
+    const char* const MalformedSpecs[] =
+    {
+        "",
+        "f",
+        "1f()",
+        "f(",
+        "f(1)",
+        "f(a,)",
+        "f(,a)",
+        "f(a b)",
+        "f(a=)",
+        "f(a=b)",
+        "f(a=1.)",
+        "f(a=.5)",
+        "f(a=-1)",
+        "f(a=1.2.3)",
+        "f(a=12x)",
+        "f(a=1 2)",
+        "f(a=\"unterminated)",
+        R"(f(a="x" "y"))",
+        "f.g(a)",
+        "f(a) g",
+        "f((a))",
+        "f(?)",
+        "f(a?)",
+        "f(a=?)",
+        "f?(a)",
+        "f(a:b)",
+        "f(a;)",
+        "f(a+b)",
+    };
+
+    for (const char* spec : MalformedSpecs)
+    {
+        const size_t size = std::char_traits<char>::length(spec);
+        EXPECT_THROW((parseStaticFunctionSpec<4>(spec, size)), std::logic_error) << spec;
+        EXPECT_FALSE(tryParseFunctionSpec(spec)) << spec;
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "SymbolTable.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(SymbolTableTest, intern)
+{
+    SymbolTable symbols;
+    EXPECT_EQ(0u, symbols.getSize());
+
+    const SymbolId foo = symbols.intern("foo");
+    const SymbolId bar = symbols.intern(std::string("bar"));
+
+    EXPECT_NE(InvalidSymbolId, foo);
+    EXPECT_NE(InvalidSymbolId, bar);
+    EXPECT_NE(foo, bar);
+    EXPECT_EQ(foo, symbols.intern("foo"));
+    EXPECT_EQ(2u, symbols.getSize());
+
+    EXPECT_EQ("foo", symbols.getName(foo));
+    EXPECT_EQ("bar", symbols.getName(bar));
+}
+
+TEST(SymbolTableTest, find)
+{
+    SymbolTable symbols;
+    const SymbolId foo = symbols.intern("foo");
+
+    EXPECT_EQ(foo, symbols.find("foo"));
+    EXPECT_EQ(InvalidSymbolId, symbols.find("fo"));
+    EXPECT_EQ(InvalidSymbolId, symbols.find(""));
+    EXPECT_EQ(1u, symbols.getSize());
+}
+
+TEST(SymbolTableTest, namesStayValid)
+{
+    SymbolTable symbols;
+    const SymbolId first = symbols.intern("a");
+    const boost::string_view firstName = symbols.getName(first);
+
+    // Short names are stored inline in std::string, make sure they don't move.
+    for (int i = 0; i < 10000; ++i)
+    {
+        symbols.intern("name" + std::to_string(i));
+    }
+
+    EXPECT_EQ(firstName.data(), symbols.getName(first).data());
+    EXPECT_EQ(first, symbols.find("a"));
+    EXPECT_EQ(symbols.intern("name9999"), symbols.find("name9999"));
+}
+
+TEST(SymbolTableTest, invalidIds)
+{
+    SymbolTable symbols;
+    symbols.intern("foo");
+
+    EXPECT_TRUE(symbols.getName(InvalidSymbolId).empty());
+    EXPECT_TRUE(symbols.getName(2).empty());
+}
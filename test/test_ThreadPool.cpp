@@ -0,0 +1,91 @@
+/*
+ * This file is licensed under CC0 license.
+ * Author: Vasily Nemkov (v.nemkov@gmail.com)
+*/
+
+#include "ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTest, executesAllTasks)
+{
+    std::atomic<int> counter(0);
+    std::vector<std::future<void>> results;
+    {
+        ThreadPool pool(4);
+        EXPECT_EQ(4u, pool.getThreadCount());
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            results.push_back(pool.submit([&counter]()
+            {
+                ++counter;
+            }));
+        }
+
+        for (auto& result : results)
+        {
+            result.get();
+        }
+        EXPECT_EQ(1000, counter);
+    }
+}
+
+TEST(ThreadPoolTest, drainsQueueOnDestruction)
+{
+    std::atomic<int> counter(0);
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.submit([&counter]()
+            {
+                ++counter;
+            });
+        }
+    }
+    EXPECT_EQ(100, counter);
+}
+
+TEST(ThreadPoolTest, propagatesExceptions)
+{
+    ThreadPool pool(1);
+    std::future<void> result = pool.submit([]()
+    {
+        throw std::runtime_error("test");
+    });
+
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, defaultThreadCount)
+{
+    ThreadPool pool;
+    EXPECT_LT(0u, pool.getThreadCount());
+}
+
+TEST(ThreadPoolTest, tasksSpawnedFromWorkers)
+{
+    std::atomic<int> counter(0);
+    // Must outlive the pool.
+    std::function<void (int)> spawn;
+    {
+        ThreadPool pool(4);
+        spawn = [&](int depth)
+        {
+            ++counter;
+            if (depth > 0)
+            {
+                pool.post([&spawn, depth]() { spawn(depth - 1); });
+                pool.post([&spawn, depth]() { spawn(depth - 1); });
+            }
+        };
+        pool.post([&spawn]() { spawn(10); });
+    }
+    // Full binary tree of depth 10.
+    EXPECT_EQ(2047, counter);
+}
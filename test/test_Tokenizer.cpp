@@ -76,6 +76,9 @@ const TokenTestCase TokenOneTypeTestCases[] =
     ONE_TOKEN_TEST_CASE(R"("abc")", TOKEN_QUOTED_STRING),
     ONE_TOKEN_TEST_CASE(R"(" ")", TOKEN_QUOTED_STRING),
     ONE_TOKEN_TEST_CASE(R"("\"")", TOKEN_QUOTED_STRING),
+    ONE_TOKEN_TEST_CASE(R"(")", TOKEN_UNTERMINATED_STRING),
+    ONE_TOKEN_TEST_CASE(R"("abc, d)", TOKEN_UNTERMINATED_STRING),
+    ONE_TOKEN_TEST_CASE(R"("abc\")", TOKEN_UNTERMINATED_STRING),
 };
 
 const TokenTestCase TokenSplitSequenceTestCases[] =